@@ -0,0 +1,249 @@
+#include "autosave.h"
+#include "trace.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// QFile::flush only hands the data to the OS; this makes it durable
+bool syncToDisk(QFile& file)
+{
+    if (!file.flush()) return false;
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+} // namespace
+
+Autosave::Autosave()
+    : Autosave(Options())
+{
+}
+
+Autosave::Autosave(const Options& options)
+    : opts(options)
+{
+    writer = std::thread(&Autosave::writerLoop, this);
+}
+
+Autosave::~Autosave()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join(); // everything queued is committed before the writer exits
+}
+
+void Autosave::checkpoint(const Table& table, int difficulty, const QString& folderPath)
+{
+    const Shoe& shoe = table.shoe();
+    ++sequence;
+
+    // a reshuffled (or reloaded) shoe can't be described as "n more cards
+    // dealt", so that and every compactEvery'th round get a full snapshot.
+    // A shuffling machine puts the round's cards back at random without a
+    // new generation, so there every round is a snapshot.
+    const bool fullSnapshot = !haveBase
+        || table.rules().continuousShuffle
+        || shoe.generation() != shoeGeneration
+        || table.rules().numDecks != numDecks
+        || shoe.remaining() > shoeRemaining
+        || table.handCount() > 1 // the journal only carries one player hand
+        || ++sinceSnapshot >= opts.compactEvery;
+
+    scratch.clear();
+    if (fullSnapshot) {
+        SaveGame save;
+        save.difficulty = difficulty;
+        save.folderPath = folderPath.toStdString();
+        save.table = table.snapshot();
+        save.sequence = sequence;
+        encodeSave(save, scratch);
+        sinceSnapshot = 0;
+        haveBase = true;
+    } else {
+        JournalEntry entry;
+        entry.sequence = sequence;
+        entry.balance = table.balance();
+        entry.currentBet = table.currentBet();
+        entry.flags = static_cast<std::uint8_t>((table.inProgress() ? InProgress : 0)
+                                                | (table.holeCardRevealed() ? HoleCardRevealed : 0)
+                                                | (table.canSurrender() ? CanSurrender : 0));
+        entry.cardsConsumed = static_cast<std::uint16_t>(shoeRemaining - shoe.remaining());
+        entry.player = table.playerHand(0);
+        entry.dealer = table.dealerHand();
+        appendJournalEntry(entry, scratch);
+    }
+
+    shoeGeneration = shoe.generation();
+    shoeRemaining = shoe.remaining();
+    numDecks = table.rules().numDecks;
+
+    enqueue(fullSnapshot ? JobType::Snapshot : JobType::Journal,
+            QByteArray(reinterpret_cast<const char*>(scratch.data()), static_cast<qsizetype>(scratch.size())));
+}
+
+void Autosave::discard()
+{
+    haveBase = false;
+    sinceSnapshot = 0;
+    enqueue(JobType::Discard, QByteArray());
+}
+
+void Autosave::resumeAfter(std::uint32_t recoveredSequence)
+{
+    sequence = recoveredSequence;
+    haveBase = false; // first checkpoint writes a fresh snapshot
+}
+
+void Autosave::flush()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    const quint64 target = queued;
+    flushRequested = true;
+    wake.notify_one();
+    committed.wait(guard, [&] { return written >= target; });
+}
+
+void Autosave::enqueue(JobType type, QByteArray bytes)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pending.push_back(Job{type, std::move(bytes)});
+        ++queued;
+    }
+    wake.notify_one();
+}
+
+void Autosave::writerLoop()
+{
+    Trace::nameThread("Autosave");
+    QFile journal(opts.journalPath);
+    QByteArray batch;
+
+    for (;;) {
+        std::deque<Job> jobs;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&] { return !pending.empty() || stopping; });
+            if (pending.empty()) break; // stopping and nothing left
+
+            // let a few more rounds pile up so they share one fsync
+            wake.wait_for(guard, opts.commitInterval, [&] { return stopping || flushRequested; });
+            flushRequested = false;
+            jobs.swap(pending);
+        }
+
+        TRACE_SCOPE("autosave commit", "worker");
+        batch.clear();
+        for (const Job& job : jobs) {
+            switch (job.type) {
+            case JobType::Journal:
+                batch += job.bytes;
+                break;
+            case JobType::Snapshot:
+                batch.clear(); // anything before the snapshot is already in it
+                writeSnapshot(job.bytes, journal);
+                break;
+            case JobType::Discard:
+                batch.clear();
+                journal.close();
+                QFile::remove(opts.journalPath); // journal first: it's meaningless without the snapshot
+                QFile::remove(opts.snapshotPath);
+                break;
+            }
+        }
+
+        if (!batch.isEmpty() && (journal.isOpen() || openJournal(journal, false))) {
+            journal.write(batch);
+            syncToDisk(journal);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            written += jobs.size();
+        }
+        committed.notify_all();
+    }
+}
+
+bool Autosave::writeSnapshot(const QByteArray& bytes, QFile& journal)
+{
+    // QSaveFile writes a temp file, syncs it and renames it over the old
+    // snapshot, so there's always one complete snapshot on disk
+    QSaveFile file(opts.snapshotPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !file.commit()) {
+        return false;
+    }
+
+    // old journal records are covered by the new snapshot now. If we crash
+    // before this, recovery skips them by sequence number.
+    journal.close();
+    return openJournal(journal, true);
+}
+
+bool Autosave::openJournal(QFile& journal, bool truncate)
+{
+    const QIODevice::OpenMode mode = QIODevice::WriteOnly | (truncate ? QIODevice::Truncate : QIODevice::Append);
+    if (!journal.open(mode)) return false;
+    if (truncate) syncToDisk(journal);
+    return true;
+}
+
+bool Autosave::recover(const Options& options, SaveGame& save, QString* report)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile snapshot(options.snapshotPath);
+    if (!snapshot.open(QIODevice::ReadOnly)) return false;
+
+    const QByteArray snapshotBytes = snapshot.readAll();
+    const SaveError error = decodeSave(reinterpret_cast<const std::uint8_t*>(snapshotBytes.constData()),
+                                       static_cast<std::size_t>(snapshotBytes.size()), save);
+    if (error != SaveError::None) {
+        if (report) *report = QString("autosave snapshot unusable: %1").arg(saveErrorText(error));
+        return false;
+    }
+
+    // replay the journal: records must carry on from the snapshot one by
+    // one; a gap, a stale record or a torn tail ends the replay
+    int applied = 0;
+    qsizetype tornBytes = 0;
+    QFile journal(options.journalPath);
+    if (journal.open(QIODevice::ReadOnly)) {
+        const QByteArray journalBytes = journal.readAll();
+        std::vector<JournalEntry> entries;
+        const std::size_t valid = readJournal(reinterpret_cast<const std::uint8_t*>(journalBytes.constData()),
+                                              static_cast<std::size_t>(journalBytes.size()), entries);
+        tornBytes = journalBytes.size() - static_cast<qsizetype>(valid);
+
+        for (const JournalEntry& entry : entries) {
+            if (entry.sequence <= save.sequence) continue;
+            if (entry.sequence != save.sequence + 1 || !applyJournalEntry(entry, save.table)) break;
+            save.sequence = entry.sequence;
+            ++applied;
+        }
+    }
+
+    if (report) {
+        *report = QString("autosave #%1 recovered (snapshot + %2 journal records%3) in %4 ms")
+                      .arg(save.sequence)
+                      .arg(applied)
+                      .arg(tornBytes ? QString(", %1 torn bytes ignored").arg(tornBytes) : QString())
+                      .arg(timer.elapsed());
+    }
+    return true;
+}
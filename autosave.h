@@ -0,0 +1,101 @@
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include <QByteArray>
+#include <QString>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "savegame.h"
+#include "table.h"
+
+class QFile;
+
+// Crash-safe autosave. checkpoint() is called after every round from the
+// GUI thread; it only encodes a few bytes and hands them to a background
+// writer, so the GUI never waits on the disk.
+//
+// On disk there are two files:
+//  - a full snapshot (same format as save.bin), replaced atomically with
+//    temp-file-plus-rename (QSaveFile)
+//  - an append-only journal of per-round deltas since that snapshot
+//
+// The writer commits whatever has queued up in one write and one fsync
+// (group commit). Every compactEvery rounds, or when the shoe is
+// reshuffled (every round with a continuous shuffling machine), a new
+// snapshot is written and the journal starts over.
+// recover() loads the snapshot and replays the journal tail on top of it.
+class Autosave
+{
+public:
+    struct Options {
+        QString snapshotPath = "autosave.bin";
+        QString journalPath = "autosave.journal";
+        int compactEvery = 64;                          // rounds per snapshot
+        std::chrono::milliseconds commitInterval{50};   // how long the writer gathers a batch
+    };
+
+    Autosave();
+    explicit Autosave(const Options& options);
+    ~Autosave();
+
+    Autosave(const Autosave&) = delete;
+    Autosave& operator=(const Autosave&) = delete;
+
+    // record the table as it stands now
+    void checkpoint(const Table& table, int difficulty, const QString& folderPath);
+
+    // forget the saved game (game over); the next checkpoint starts fresh
+    void discard();
+
+    // carry on numbering after a recovered save so its journal can't be
+    // mistaken for ours
+    void resumeAfter(std::uint32_t recoveredSequence);
+
+    // wait until everything checkpointed so far is on disk
+    void flush();
+
+    // snapshot + journal tail, false if there's nothing usable on disk.
+    // report says what was found (for the log).
+    static bool recover(const Options& options, SaveGame& save, QString* report = nullptr);
+
+    const Options& options() const { return opts; }
+
+private:
+    enum class JobType { Snapshot, Journal, Discard };
+    struct Job {
+        JobType type;
+        QByteArray bytes;
+    };
+
+    void enqueue(JobType type, QByteArray bytes);
+    void writerLoop();
+    bool writeSnapshot(const QByteArray& bytes, QFile& journal);
+    bool openJournal(QFile& journal, bool truncate);
+
+    Options opts;
+
+    // GUI thread only: what the last checkpoint looked like
+    std::uint32_t sequence = 0;
+    int sinceSnapshot = 0;
+    bool haveBase = false;
+    unsigned shoeGeneration = 0;
+    std::size_t shoeRemaining = 0;
+    int numDecks = 0;
+    std::vector<std::uint8_t> scratch;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable committed;
+    std::deque<Job> pending;        // guarded by lock
+    quint64 queued = 0;             // guarded by lock
+    quint64 written = 0;            // guarded by lock
+    bool flushRequested = false;    // guarded by lock
+    bool stopping = false;          // guarded by lock
+
+    std::thread writer;
+};
+
+#endif // AUTOSAVE_H
@@ -0,0 +1,304 @@
+// blackjack_bench - micro benchmarks for the engine hot paths.
+//
+//   blackjack_bench [--json FILE] [--baseline FILE] [--max-ns NAME=N] ...
+//
+// See benchharness.h for the options. CMake registers a run with limits
+// as the bench_engine test.
+
+#include "benchharness.h"
+#include "evsolver.h"
+#include "handeval.h"
+#include "rng.h"
+#include "ruleset.h"
+#include "savegame.h"
+#include "session.h"
+#include "strategy.h"
+#include "table.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+void benchShuffle(BenchSuite& bench)
+{
+    for (int decks : { 1, 2, 4, 6, 8 }) {
+        Shoe shoe(decks);
+        Rng rng(3);
+        const int n = 2000;
+        bench.run("shuffle_" + std::to_string(decks) + "d", n, 5, [&] {
+            for (int i = 0; i < n; ++i) shoe.shuffle(rng);
+        });
+    }
+}
+
+void benchDraw(BenchSuite& bench)
+{
+    // draw every card of an 8 deck shoe, then put the shoe back by copy
+    // (same capacity, no allocation) - the reshuffle isn't what's measured
+    Shoe pristine(8);
+    Rng rng(5);
+    pristine.shuffle(rng);
+    Shoe shoe = pristine;
+
+    const int shoes = 500;
+    const std::size_t draws = static_cast<std::size_t>(shoes) * pristine.size();
+    unsigned sink = 0;
+    bench.run("draw_card", draws, 5, [&] {
+        for (int s = 0; s < shoes; ++s) {
+            shoe = pristine;
+            while (!shoe.empty()) sink += shoe.draw().code;
+        }
+    });
+    if (sink == 1) std::printf("%u\n", sink); // keep the loop
+}
+
+void benchHandValue(BenchSuite& bench)
+{
+    const std::size_t count = 1 << 20;
+
+    // random 2..6 card hands
+    Rng rng(7);
+    std::vector<Hand> hands(count);
+    HandBatch batch;
+    batch.reserve(count);
+    for (Hand& h : hands) {
+        const int cards = 2 + static_cast<int>(rng.below(5));
+        for (int c = 0; c < cards; ++c) {
+            h.push_back(Card::make(1 + static_cast<int>(rng.below(13)), static_cast<Card::Suit>(rng.below(4))));
+        }
+        batch.add(h);
+    }
+
+    std::vector<std::uint8_t> reference(count);
+    HandBatchResult scalar, simd;
+
+    const double refNs = bench.run("hand_value", count, 5, [&] {
+        for (std::size_t i = 0; i < count; ++i) reference[i] = static_cast<std::uint8_t>(handValue(hands[i]));
+    });
+    const double scalarNs = bench.run("hand_value_batch_scalar", count, 5, [&] { evaluateHandsScalar(batch, scalar); });
+    const double simdNs = bench.run(std::string("hand_value_batch_") + handEvalKernelName(), count, 5,
+                                    [&] { evaluateHands(batch, simd); });
+    if (refNs == 0.0 || scalarNs == 0.0 || simdNs == 0.0) return; // filtered
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const bool soft = isSoftHand(hands[i]);
+        const bool natural = reference[i] == 21 && hands[i].size() == 2;
+        if (simd.total[i] != reference[i] || scalar.total[i] != reference[i]
+            || simd.soft(i) != soft || simd.bust(i) != (reference[i] > 21) || simd.natural(i) != natural
+            || scalar.soft(i) != soft || scalar.bust(i) != (reference[i] > 21) || scalar.natural(i) != natural) {
+            bench.fail("hand evaluation mismatch at hand " + std::to_string(i));
+            return;
+        }
+    }
+    std::printf("  batch speedup: scalar %.1fx, %s %.1fx\n", refNs / scalarNs, handEvalKernelName(), refNs / simdNs);
+}
+
+void benchRounds(BenchSuite& bench)
+{
+    // settlement alone: deal a round on each of many tables (untimed),
+    // then time endRound over all of them. Every pass deals fresh rounds,
+    // settling a settled table would only time the early outs.
+    const int tables = 1 << 14;
+    std::vector<Table> dealt(tables);
+    for (int i = 0; i < tables; ++i) {
+        dealt[i].seed(100 + i);
+    }
+    auto deal = [&] {
+        for (int i = 0; i < tables; ++i) {
+            dealt[i].setBalance(1000);
+            dealt[i].placeBet(10);
+            dealt[i].dealInitialCards();
+            if (i % 3 == 0) dealt[i].hit();
+            dealt[i].revealHoleCard();
+            dealt[i].playDealer();
+        }
+    };
+    long long sink = 0;
+    bench.run("end_round", tables, 5, deal, [&] {
+        for (Table& t : dealt) {
+            sink += t.endRound().returned;
+        }
+    });
+
+    // a whole round with basic strategy
+    Rules rules;
+    rules.numDecks = 6;
+    Table table(rules);
+    table.seed(9);
+    BasicStrategyPolicy policy;
+    const long long rounds = 200000;
+    bench.run("play_round", rounds, 5, [&] { sink += table.playRounds(rounds, policy, 10).net; });
+
+    // the loop the simulator runs for these rules (see withRuleSet);
+    // expected to match play_round, see ruleset.h
+    Table specialized(rules);
+    specialized.seed(9);
+    bench.run("play_round_specialized", rounds, 5, [&] {
+        sink += specialized.playRounds<RuleSet<17, 3, 2, true, true>>(rounds, policy, 10).net;
+    });
+
+    // same from a shuffling machine: a random draw per card and every
+    // card back in the shoe after the round
+    rules.continuousShuffle = true;
+    Table csm(rules);
+    csm.seed(9);
+    bench.run("play_round_csm", rounds, 5, [&] { sink += csm.playRounds(rounds, policy, 10).net; });
+
+    if (sink == 1) std::printf("%lld\n", sink);
+}
+
+// Not a timing: the solver has to value a hand the way the table pays
+// it. Always standing on one deck, reshuffled every round, the solver's
+// EV over every first deal must match the table's result within noise.
+void checkSolverAgainstEngine(BenchSuite& bench)
+{
+    if (!bench.enabled("solver_vs_engine")) return;
+
+    struct StandPolicy {
+        Action operator()(const Table&) const { return Action::Stand; }
+    };
+    auto cardOf = [](int index) { return Card::make(index == 0 ? 1 : index + 1, Card::Clubs); };
+
+    Rules rules;
+    rules.numDecks = 1;
+    rules.penetration = 0.0; // fresh shoe every round
+
+    EvSolver solver(rules);
+    ShoeComposition full;
+    for (int i = 0; i < 9; ++i) full.counts[i] = 4;
+    full.counts[9] = 16;
+    full.total = 52;
+
+    double solverEv = 0.0;
+    for (int a = 0; a < 10; ++a) {
+        ShoeComposition afterA = full;
+        const double pa = static_cast<double>(afterA.counts[a]) / afterA.total;
+        afterA.remove(cardOf(a));
+        for (int b = 0; b < 10; ++b) {
+            if (afterA.counts[b] == 0) continue;
+            ShoeComposition afterB = afterA;
+            const double pb = static_cast<double>(afterB.counts[b]) / afterB.total;
+            afterB.remove(cardOf(b));
+            for (int u = 0; u < 10; ++u) {
+                if (afterB.counts[u] == 0) continue;
+                ShoeComposition unseen = afterB;
+                const double pu = static_cast<double>(unseen.counts[u]) / unseen.total;
+                unseen.remove(cardOf(u));
+                const Hand hand = { cardOf(a), cardOf(b) };
+                solverEv += pa * pb * pu * solver.evaluate(hand, cardOf(u), unseen, false).stand;
+            }
+        }
+    }
+
+    const long long rounds = 2000000;
+    const int bet = 10;
+    Table table(rules);
+    table.seed(11);
+    const RoundStats stats = table.playRounds(rounds, StandPolicy(), bet);
+    const double engineEv = -stats.houseEdge();
+    const double error = std::sqrt(stats.variancePerRound() / rounds) / bet;
+
+    std::printf("  solver_vs_engine             solver %+.4f  table %+.4f  (se %.4f)\n", solverEv, engineEv, error);
+    if (std::fabs(solverEv - engineEv) > 4.0 * error) {
+        bench.fail("solver EV " + std::to_string(solverEv) + " doesn't match the table's " + std::to_string(engineEv));
+    }
+}
+
+void benchSaveLoad(BenchSuite& bench)
+{
+    const char* path = "bench_save.bin";
+
+    for (int decks : { 1, 2, 4, 6, 8 }) {
+        Rules rules;
+        rules.numDecks = decks;
+        Table table(rules);
+        table.seed(11);
+        table.setBalance(10000);
+        table.placeBet(100);
+        table.dealInitialCards();
+
+        SaveGame save;
+        save.folderPath = "C:/Users/player/Documents";
+        save.table = table.snapshot();
+
+        std::vector<std::uint8_t> bytes;
+        encodeSave(save, bytes);
+        SaveGame loaded;
+        const int n = 2000;
+        const std::string suffix = "_" + std::to_string(decks) + "d";
+
+        bench.run("save_encode" + suffix, n, 5, [&] {
+            for (int i = 0; i < n; ++i) encodeSave(save, bytes);
+        });
+        bench.run("save_decode" + suffix, n, 5, [&] {
+            for (int i = 0; i < n; ++i) decodeSave(bytes.data(), bytes.size(), loaded);
+        });
+
+        // whole round trip through the file system, like saveGameToFile/loadGameFromFile
+        const int fileRuns = 200;
+        std::vector<std::uint8_t> readBack(bytes.size());
+        bench.run("save_file_roundtrip" + suffix, fileRuns, 3, [&] {
+            for (int i = 0; i < fileRuns; ++i) {
+                if (FILE* f = std::fopen(path, "wb")) {
+                    std::fwrite(bytes.data(), 1, bytes.size(), f);
+                    std::fclose(f);
+                }
+                if (FILE* f = std::fopen(path, "rb")) {
+                    std::fread(readBack.data(), 1, readBack.size(), f);
+                    std::fclose(f);
+                }
+                decodeSave(readBack.data(), readBack.size(), loaded);
+            }
+        });
+
+        if (bench.enabled("save_decode" + suffix) && loaded.table.shoe != save.table.shoe) {
+            bench.fail("save round trip failed at " + std::to_string(decks) + " decks");
+        }
+    }
+
+    std::remove(path);
+}
+
+void benchReplay(BenchSuite& bench)
+{
+    if (!bench.enabled("replay_round")) return;
+
+    SessionRecorder recorder;
+    Rules rules;
+    rules.numDecks = 6;
+    Table table(rules);
+    table.setRecorder(&recorder);
+    table.seed(21);
+    table.setBalance(1000000000LL);
+    BasicStrategyPolicy policy;
+    const int rounds = 100000;
+    for (int i = 0; i < rounds; ++i) table.playRound(10, policy);
+
+    std::vector<std::uint8_t> session;
+    recorder.takeBytes(session);
+
+    ReplayResult result;
+    bench.run("replay_round", rounds, 3, [&] { result = replaySession(session.data(), session.size()); });
+    if (!result.ok || result.finalBalance != table.balance()) {
+        bench.fail("replay diverged: " + result.error);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchSuite bench("blackjack_bench");
+    if (!bench.parseArgs(argc, argv)) return 2;
+
+    benchShuffle(bench);
+    benchDraw(bench);
+    benchHandValue(bench);
+    benchRounds(bench);
+    checkSolverAgainstEngine(bench);
+    benchSaveLoad(bench);
+    benchReplay(bench);
+    return bench.finish();
+}
@@ -0,0 +1,161 @@
+#include "benchharness.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+// ---------------- Allocation counting ----------------
+
+namespace {
+std::atomic<std::uint64_t> allocations{0};
+}
+
+std::uint64_t allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+// the array and nothrow forms end up in this one
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// ---------------- BenchSuite ----------------
+
+namespace {
+
+bool parseLimit(const char* arg, std::map<std::string, double>& limits)
+{
+    const char* eq = std::strchr(arg, '=');
+    if (!eq || eq == arg) return false;
+    limits[std::string(arg, eq)] = std::atof(eq + 1);
+    return true;
+}
+
+} // namespace
+
+bool BenchSuite::parseArgs(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        bool ok = true;
+
+        if (!std::strcmp(arg, "--json") && hasValue) jsonPath = argv[++i];
+        else if (!std::strcmp(arg, "--baseline") && hasValue) baselinePath = argv[++i];
+        else if (!std::strcmp(arg, "--tolerance") && hasValue) tolerance = std::atof(argv[++i]);
+        else if (!std::strcmp(arg, "--filter") && hasValue) filter = argv[++i];
+        else if (!std::strcmp(arg, "--max-ns") && hasValue) ok = parseLimit(argv[++i], maxNs);
+        else if (!std::strcmp(arg, "--max-allocs") && hasValue) ok = parseLimit(argv[++i], maxAllocs);
+        else ok = false;
+
+        if (!ok) {
+            std::fprintf(stderr,
+                         "usage: %s [--json FILE] [--baseline FILE] [--tolerance X] [--filter TEXT]\n"
+                         "       %*s [--max-ns NAME=N]... [--max-allocs NAME=N]...\n",
+                         program, static_cast<int>(std::strlen(program)), "");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BenchSuite::enabled(const std::string& name) const
+{
+    return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+void BenchSuite::record(const std::string& name, double nsPerOp, double allocsPerOp)
+{
+    results.push_back(Result{name, nsPerOp, allocsPerOp});
+    std::printf("  %-28s %12.2f ns/op  %8.2f allocs/op\n", name.c_str(), nsPerOp, allocsPerOp);
+    std::fflush(stdout);
+}
+
+void BenchSuite::fail(const std::string& why)
+{
+    std::fprintf(stderr, "FAIL: %s\n", why.c_str());
+    failures.push_back(why);
+}
+
+int BenchSuite::finish()
+{
+    char buf[256];
+
+    // limits given on the command line (CTest)
+    for (const Result& r : results) {
+        auto ns = maxNs.find(r.name);
+        if (ns != maxNs.end() && r.nsPerOp > ns->second) {
+            std::snprintf(buf, sizeof(buf), "%s: %.2f ns/op over the limit of %.2f", r.name.c_str(), r.nsPerOp, ns->second);
+            fail(buf);
+        }
+        auto allocs = maxAllocs.find(r.name);
+        if (allocs != maxAllocs.end() && r.allocsPerOp > allocs->second) {
+            std::snprintf(buf, sizeof(buf), "%s: %.2f allocs/op over the limit of %.2f", r.name.c_str(), r.allocsPerOp, allocs->second);
+            fail(buf);
+        }
+    }
+
+    // earlier run: one result per line, as written below
+    if (!baselinePath.empty()) {
+        std::ifstream in(baselinePath);
+        if (!in) fail("can't read baseline " + baselinePath);
+
+        std::string line;
+        while (std::getline(in, line)) {
+            char name[128];
+            double ns = 0.0, allocs = 0.0;
+            if (std::sscanf(line.c_str(), " {\"name\": \"%127[^\"]\", \"ns_per_op\": %lf, \"allocs_per_op\": %lf",
+                            name, &ns, &allocs) != 3) continue;
+
+            for (const Result& r : results) {
+                if (r.name != name) continue;
+                if (ns > 0.0 && r.nsPerOp > ns * (1.0 + tolerance)) {
+                    std::snprintf(buf, sizeof(buf), "%s: %.2f ns/op, baseline %.2f (+%.0f%%)",
+                                  name, r.nsPerOp, ns, (r.nsPerOp / ns - 1.0) * 100.0);
+                    fail(buf);
+                }
+                if (r.allocsPerOp > allocs + 0.01) {
+                    std::snprintf(buf, sizeof(buf), "%s: %.2f allocs/op, baseline %.2f", name, r.allocsPerOp, allocs);
+                    fail(buf);
+                }
+            }
+        }
+    }
+
+    if (!jsonPath.empty()) {
+        if (FILE* f = std::fopen(jsonPath.c_str(), "w")) {
+            std::fprintf(f, "{\n  \"program\": \"%s\",\n  \"benchmarks\": [\n", program);
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                const Result& r = results[i];
+                std::fprintf(f, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"allocs_per_op\": %.3f}%s\n",
+                             r.name.c_str(), r.nsPerOp, r.allocsPerOp, i + 1 < results.size() ? "," : "");
+            }
+            std::fprintf(f, "  ],\n  \"failures\": %zu\n}\n", failures.size());
+            std::fclose(f);
+        } else {
+            fail("can't write " + jsonPath);
+        }
+    }
+
+    if (!failures.empty()) {
+        std::printf("%zu check(s) failed\n", failures.size());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Self-contained benchmark harness shared by blackjack_bench (engine) and
+// blackjack_bench_gui (Qt side).
+//
+//   --json FILE             write the results as JSON
+//   --baseline FILE         compare against an earlier --json run
+//   --tolerance X           allowed slowdown against the baseline (0.25 = 25%)
+//   --max-ns NAME=N         fail if NAME takes more than N ns/op
+//   --max-allocs NAME=N     fail if NAME makes more than N allocations/op
+//   --filter TEXT           only run benchmarks whose name contains TEXT
+//
+// Allocations are counted by replacing global operator new (in
+// benchharness.cpp), so they cover the engine and std containers. Qt's
+// own containers allocate with malloc and don't show up.
+
+// operator new calls so far
+std::uint64_t allocationCount();
+
+class BenchSuite
+{
+public:
+    struct Result {
+        std::string name;
+        double nsPerOp = 0.0;
+        double allocsPerOp = 0.0;
+    };
+
+    explicit BenchSuite(const char* program) : program(program) {}
+
+    // false (after printing usage) on bad arguments
+    bool parseArgs(int argc, char* argv[]);
+
+    bool enabled(const std::string& name) const;
+
+    // Times fn, which performs ops operations, repeats times and keeps the
+    // fastest run. Allocations are averaged over all runs. Returns ns/op
+    // (0 if the benchmark is filtered out).
+    template <typename Fn>
+    double run(const std::string& name, std::size_t ops, int repeats, Fn&& fn);
+
+    // Same, with setup run untimed before every pass (and the warm up) to
+    // put back whatever fn used up. Its allocations aren't counted.
+    template <typename Setup, typename Fn>
+    double run(const std::string& name, std::size_t ops, int repeats, Setup&& setup, Fn&& fn);
+
+    // something went wrong that isn't a timing (wrong result etc.)
+    void fail(const std::string& why);
+
+    // prints the summary, writes JSON, checks limits and baseline;
+    // returns the process exit code
+    int finish();
+
+private:
+    void record(const std::string& name, double nsPerOp, double allocsPerOp);
+
+    const char* program;
+    std::string jsonPath;
+    std::string baselinePath;
+    std::string filter;
+    double tolerance = 0.25;
+    std::map<std::string, double> maxNs;
+    std::map<std::string, double> maxAllocs;
+
+    std::vector<Result> results;
+    std::vector<std::string> failures;
+};
+
+template <typename Fn>
+double BenchSuite::run(const std::string& name, std::size_t ops, int repeats, Fn&& fn)
+{
+    return run(name, ops, repeats, [] {}, fn);
+}
+
+template <typename Setup, typename Fn>
+double BenchSuite::run(const std::string& name, std::size_t ops, int repeats, Setup&& setup, Fn&& fn)
+{
+    if (!enabled(name)) return 0.0;
+
+    setup();
+    fn(); // warm up caches and let buffers reach their working size
+
+    double best = 1e300;
+    std::uint64_t allocs = 0;
+    for (int r = 0; r < repeats; ++r) {
+        setup();
+        const std::uint64_t allocsBefore = allocationCount();
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        allocs += allocationCount() - allocsBefore;
+        if (ns < best) best = ns;
+    }
+
+    const double nsPerOp = best / ops;
+    record(name, nsPerOp, static_cast<double>(allocs) / (static_cast<double>(ops) * repeats));
+    return nsPerOp;
+}
+
+#endif // BENCHHARNESS_H
@@ -0,0 +1,53 @@
+#ifndef CARD_H
+#define CARD_H
+
+#include <cstdint>
+
+// Packed card: one byte, low nibble is the rank (1 = Ace ... 13 = King),
+// high nibble the suit. Value, ace flag and display text come out of
+// constexpr tables so a shoe is just a flat byte array and building or
+// drawing cards never allocates.
+// No Qt in here on purpose - the engine has to run without widgets.
+
+namespace CardTables {
+// index by rank, 0 is "no card"
+constexpr std::uint8_t value[16] = { 0, 11, 2, 3, 4, 5, 6, 7, 8, 9, 10, 10, 10, 10, 0, 0 };
+constexpr const char* rankName[16] = { "?", "A", "2", "3", "4", "5", "6", "7",
+                                       "8", "9", "10", "J", "Q", "K", "?", "?" };
+}
+
+struct Card {
+    enum Suit : std::uint8_t { Hearts, Diamonds, Clubs, Spades };
+
+    std::uint8_t code = 0;
+
+    static constexpr Card make(int rank, Suit suit)
+    {
+        return Card{ static_cast<std::uint8_t>((suit << 4) | (rank & 0x0F)) };
+    }
+
+    constexpr int rank() const { return code & 0x0F; }
+    constexpr Suit suit() const { return static_cast<Suit>(code >> 4); }
+    constexpr int value() const { return CardTables::value[rank()]; } // aces count 11 here
+    constexpr bool isAce() const { return rank() == 1; }
+    constexpr const char* rankString() const { return CardTables::rankName[rank()]; }
+
+    // reverse of rankString, returns 0 if it isn't a rank
+    static int rankFromString(const char* s)
+    {
+        for (int r = 1; r <= 13; ++r) {
+            const char* n = CardTables::rankName[r];
+            int i = 0;
+            while (n[i] && s[i] == n[i]) ++i;
+            if (!n[i] && !s[i]) return r;
+        }
+        return 0;
+    }
+
+    constexpr bool operator==(Card other) const { return code == other.code; }
+    constexpr bool operator!=(Card other) const { return code != other.code; }
+};
+
+static_assert(sizeof(Card) == 1, "Card must stay one byte");
+
+#endif // CARD_H
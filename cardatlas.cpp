@@ -0,0 +1,118 @@
+#include "cardatlas.h"
+#include "cardview.h"
+#include <QFont>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPixmapCache>
+#include <QtMath>
+
+namespace {
+
+constexpr int COLUMNS = 13;
+constexpr int ROWS = 5; // four suits, then the back
+
+QString cacheKey(QSize cardSize, qreal dpr)
+{
+    return QString("cardatlas:%1x%2@%3").arg(cardSize.width()).arg(cardSize.height()).arg(dpr);
+}
+
+QSize cellPixels(QSize cardSize, qreal dpr)
+{
+    return QSize(qCeil(cardSize.width() * dpr), qCeil(cardSize.height() * dpr));
+}
+
+void paintFrame(QPainter& p, const QRectF& r, const QColor& fill)
+{
+    // same look as the old stylesheet: 2px gold border, 8px corners
+    QPainterPath path;
+    path.addRoundedRect(r.adjusted(1, 1, -1, -1), 8, 8);
+    p.fillPath(path, fill);
+    p.setPen(QPen(QColor("#b39700"), 2));
+    p.drawPath(path);
+}
+
+} // namespace
+
+QPixmap CardAtlas::atlas(QSize cardSize, qreal dpr)
+{
+    QPixmap pm;
+    if (!QPixmapCache::find(cacheKey(cardSize, dpr), &pm)) {
+        pm = render(cardSize, dpr);
+        QPixmapCache::insert(cacheKey(cardSize, dpr), pm);
+    }
+    return pm;
+}
+
+QRect CardAtlas::sourceRect(int cell, QSize cardSize, qreal dpr)
+{
+    const QSize px = cellPixels(cardSize, dpr);
+    return QRect((cell % COLUMNS) * px.width(), (cell / COLUMNS) * px.height(), px.width(), px.height());
+}
+
+void CardAtlas::warmUp(QSize cardSize, qreal dpr)
+{
+    // one atlas at 2x for 80x120 cards is ~10MB, leave room for a couple
+    if (QPixmapCache::cacheLimit() < 64 * 1024) {
+        QPixmapCache::setCacheLimit(64 * 1024);
+    }
+    atlas(cardSize, dpr);
+}
+
+QPixmap CardAtlas::render(QSize cardSize, qreal dpr)
+{
+    const QSize px = cellPixels(cardSize, dpr);
+    QPixmap pm(px.width() * COLUMNS, px.height() * ROWS);
+    pm.fill(Qt::transparent);
+
+    QPainter p(&pm);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setRenderHint(QPainter::TextAntialiasing);
+    p.scale(dpr, dpr); // paint in logical pixels, land on device pixels
+
+    const qreal w = cardSize.width();
+    const qreal h = cardSize.height();
+    const qreal cellW = px.width() / dpr;
+    const qreal cellH = px.height() / dpr;
+
+    QFont corner;
+    corner.setBold(true);
+    corner.setPixelSize(14);
+    QFont center = corner;
+    center.setPixelSize(28);
+    QFont backFont = corner;
+    backFont.setPixelSize(22);
+
+    for (int s = Card::Hearts; s <= Card::Spades; ++s) {
+        for (int r = 1; r <= 13; ++r) {
+            const Card card = Card::make(r, static_cast<Card::Suit>(s));
+            const int cell = cellFor(card);
+            const QRectF box((cell % COLUMNS) * cellW, (cell / COLUMNS) * cellH, w, h);
+
+            // Base style (dark gray background)
+            paintFrame(p, box, QColor("#2a2a2a"));
+
+            // Suit color
+            const bool red = (card.suit() == Card::Hearts || card.suit() == Card::Diamonds);
+            p.setPen(red ? Qt::red : Qt::white);
+
+            const QString suit = CardView::suitToSymbol(card.suit());
+            const QString text = QString::fromLatin1(card.rankString()) + suit;
+            const QRectF inner = box.adjusted(6, 4, -6, -6);
+
+            // Top-left and bottom-right rank + suit, suit only in the center
+            p.setFont(corner);
+            p.drawText(inner, Qt::AlignLeft | Qt::AlignTop, text);
+            p.drawText(inner, Qt::AlignRight | Qt::AlignBottom, text);
+            p.setFont(center);
+            p.drawText(box, Qt::AlignCenter, suit);
+        }
+    }
+
+    const QRectF back((BACK % COLUMNS) * cellW, (BACK / COLUMNS) * cellH, w, h);
+    paintFrame(p, back, QColor("#1d3557"));
+    p.setPen(QColor("#a8dadc"));
+    p.setFont(backFont);
+    p.drawText(back, Qt::AlignCenter, "◆◇◆");
+
+    return pm;
+}
@@ -0,0 +1,33 @@
+#ifndef CARDATLAS_H
+#define CARDATLAS_H
+
+#include <QPixmap>
+#include <QRect>
+#include <QSize>
+#include "card.h"
+
+// All 52 faces plus the card back painted once into a single pixmap per
+// (card size, device pixel ratio), kept in QPixmapCache. Drawing a card is
+// then one blit of its cell; a resize or a move to a high-DPI screen just
+// picks (or paints) the atlas for the new size.
+class CardAtlas
+{
+public:
+    static constexpr int BACK = 52;   // cell index of the card back
+
+    static int cellFor(Card card) { return card.suit() * 13 + card.rank() - 1; }
+
+    // the atlas for cards of logical size cardSize on a screen with ratio dpr
+    static QPixmap atlas(QSize cardSize, qreal dpr);
+
+    // where cell sits inside that atlas, in device pixels
+    static QRect sourceRect(int cell, QSize cardSize, qreal dpr);
+
+    // paint the atlas ahead of time so the first deal doesn't pay for it
+    static void warmUp(QSize cardSize, qreal dpr);
+
+private:
+    static QPixmap render(QSize cardSize, qreal dpr);
+};
+
+#endif // CARDATLAS_H
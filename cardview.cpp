@@ -0,0 +1,95 @@
+#include "cardview.h"
+#include "cardatlas.h"
+#include <QLayout>
+#include <QPainter>
+
+CardView::CardView(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumSize(80, 120);
+    setMaximumSize(80, 120);
+}
+
+QString CardView::suitToSymbol(Card::Suit suit)
+{
+    switch (suit) {
+    case Card::Hearts:   return "♥";
+    case Card::Diamonds: return "♦";
+    case Card::Clubs:    return "♣";
+    case Card::Spades:   return "♠";
+    }
+    return "";
+}
+
+void CardView::showCard(Card card)
+{
+    if (shown == card.code) return;
+    shown = card.code;
+    cell = CardAtlas::cellFor(card);
+    update();
+}
+
+void CardView::showBack()
+{
+    if (shown == BACK) return;
+    shown = BACK;
+    cell = CardAtlas::BACK;
+    update();
+}
+
+void CardView::paintEvent(QPaintEvent *)
+{
+    if (cell < 0) return;
+
+    const qreal dpr = devicePixelRatioF();
+    const QPixmap atlas = CardAtlas::atlas(size(), dpr);
+
+    QPainter p(this);
+    p.drawPixmap(rect(), atlas, CardAtlas::sourceRect(cell, size(), dpr));
+}
+
+// ---------------- CardViewPool ----------------
+
+CardViewPool::~CardViewPool()
+{
+    qDeleteAll(spare);
+}
+
+CardView* CardViewPool::acquire()
+{
+    if (spare.isEmpty()) {
+        return new CardView();
+    }
+    return spare.takeLast();
+}
+
+void CardViewPool::release(CardView* view)
+{
+    view->hide();
+    view->setParent(nullptr);
+    spare.append(view);
+}
+
+void CardViewPool::sync(QLayout* layout, QVector<CardView*>& views, const Hand& hand, bool hideHoleCard)
+{
+    const int count = hand.size();
+
+    // hand got shorter (new round): give the extra views back
+    while (views.size() > count) {
+        CardView* card = views.takeLast();
+        layout->removeWidget(card);
+        release(card);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (i == views.size()) {
+            CardView* card = acquire();
+            views.append(card);
+            layout->addWidget(card);
+            card->show();
+        }
+        // Second dealer card hidden unless reveal flag set
+        if (i == 1 && hideHoleCard) views[i]->showBack();
+        else views[i]->showCard(hand[i]);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef CARDVIEW_H
+#define CARDVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include "card.h"
+#include "hand.h"
+
+class QLayout;
+
+// One card on the table. Built once and then re-pointed at other cards;
+// painting is a single blit out of the CardAtlas, and showCard()/showBack()
+// only schedule a repaint when the card actually changes.
+class CardView : public QWidget
+{
+public:
+    explicit CardView(QWidget *parent = nullptr);
+
+    void showCard(Card card);
+    void showBack();
+
+    // what is on screen right now: a card code, BACK, or NONE
+    int shownCode() const { return shown; }
+
+    static constexpr int NONE = -1;
+    static constexpr int BACK = 0x100;
+
+    static QString suitToSymbol(Card::Suit suit);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    int shown = NONE;
+    int cell = -1;   // atlas cell being drawn
+};
+
+// Keeps CardViews that aren't on the table so the next hand can reuse
+// them instead of building new widgets.
+class CardViewPool
+{
+public:
+    CardViewPool() = default;
+    ~CardViewPool();
+
+    CardViewPool(const CardViewPool&) = delete;
+    CardViewPool& operator=(const CardViewPool&) = delete;
+
+    CardView* acquire();
+    void release(CardView* view); // caller has taken it out of its layout
+
+    // Makes views (laid out in layout) show hand. Only cards that changed
+    // get touched: new cards are added, the hole card (second card, when
+    // hideHoleCard) flips, and a new hand reuses the views of the last one.
+    void sync(QLayout* layout, QVector<CardView*>& views, const Hand& hand, bool hideHoleCard);
+
+private:
+    QVector<CardView*> spare;
+};
+
+#endif // CARDVIEW_H
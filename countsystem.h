@@ -0,0 +1,44 @@
+#ifndef COUNTSYSTEM_H
+#define COUNTSYSTEM_H
+
+#include <cstdint>
+
+// Card counting systems: a tag per rank added to the running count as
+// each card comes out of the shoe. Balanced systems add up to zero over
+// a deck and start at zero; unbalanced ones (KO) start below zero so the
+// pivot lands where the true count of a balanced system would.
+
+enum class CountSystemId : std::uint8_t { HiLo, KO, HiOptI, OmegaII };
+
+struct CountSystem {
+    const char* name;
+    std::int8_t tag[16]; // by rank, as CardTables
+    bool balanced;
+
+    int tagsPerDeck() const
+    {
+        int sum = 0;
+        for (int r = 1; r <= 13; ++r) sum += tag[r];
+        return 4 * sum;
+    }
+
+    int startingCount(int decks) const { return balanced ? 0 : -tagsPerDeck() * (decks - 1); }
+};
+
+namespace CountTables {
+//                                   ?  A  2  3  4  5  6  7  8  9 10  J  Q  K
+constexpr CountSystem systems[] = {
+    { "Hi-Lo",    {  0, -1, 1, 1, 1, 1, 1, 0, 0, 0, -1, -1, -1, -1, 0, 0 }, true },
+    { "KO",       {  0, -1, 1, 1, 1, 1, 1, 1, 0, 0, -1, -1, -1, -1, 0, 0 }, false },
+    { "Hi-Opt I", {  0,  0, 0, 1, 1, 1, 1, 0, 0, 0, -1, -1, -1, -1, 0, 0 }, true },
+    { "Omega II", {  0,  0, 1, 1, 2, 2, 2, 1, 0, -1, -2, -2, -2, -2, 0, 0 }, true },
+};
+constexpr int numSystems = sizeof(systems) / sizeof(systems[0]);
+}
+
+inline const CountSystem& countSystem(CountSystemId id)
+{
+    return CountTables::systems[static_cast<int>(id)];
+}
+
+#endif // COUNTSYSTEM_H
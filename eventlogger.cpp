@@ -0,0 +1,180 @@
+#include "eventlogger.h"
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+
+EventLogger::EventLogger()
+    : EventLogger(Options())
+{
+}
+
+EventLogger::EventLogger(const Options& options)
+    : opts(options)
+{
+    quint64 capacity = 2;
+    while (capacity < static_cast<quint64>(opts.capacity)) capacity <<= 1;
+    mask = capacity - 1;
+
+    ring.reset(new Slot[capacity]);
+    for (quint64 i = 0; i < capacity; ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    writer = std::thread(&EventLogger::writerLoop, this);
+}
+
+EventLogger::~EventLogger()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join(); // the writer drains everything before it exits
+}
+
+void EventLogger::log(const QString& event)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    // bounded MPMC queue (Vyukov): claim a slot by bumping enqueuePos once
+    // the slot's sequence says the writer has finished with it
+    quint64 pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = ring[pos & mask];
+        const quint64 seq = slot.sequence.load(std::memory_order_acquire);
+        const qint64 diff = static_cast<qint64>(seq) - static_cast<qint64>(pos);
+
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.msecs = now;
+                slot.text = event;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+
+                // pairs with the fence in writerLoop: either the writer sees
+                // this slot before it sleeps or we see that it's asleep
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (writerIdle.load(std::memory_order_relaxed) && writerIdle.exchange(false)) {
+                    { std::lock_guard<std::mutex> guard(lock); }
+                    wake.notify_one();
+                }
+                return;
+            }
+        } else if (diff < 0) {
+            // ring is full
+            if (opts.overflow == OverflowPolicy::DropNewest) {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            wake.notify_one();
+            std::this_thread::yield();
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void EventLogger::flush()
+{
+    const quint64 target = enqueuePos.load(std::memory_order_acquire);
+
+    std::unique_lock<std::mutex> guard(lock);
+    flushRequested = true;
+    wake.notify_one();
+    flushed.wait(guard, [&] { return writtenPos >= target || stopping; });
+}
+
+quint64 EventLogger::drain(QFile& file, QByteArray& buffer)
+{
+    buffer.clear();
+
+    // timestamps only change once a second, so format them once a second
+    qint64 lastSecond = -1;
+    QByteArray stamp;
+
+    for (;;) {
+        Slot& slot = ring[dequeuePos & mask];
+        const quint64 seq = slot.sequence.load(std::memory_order_acquire);
+        if (static_cast<qint64>(seq) - static_cast<qint64>(dequeuePos + 1) < 0) break; // empty
+
+        const qint64 second = slot.msecs / 1000;
+        if (second != lastSecond) {
+            lastSecond = second;
+            stamp = QDateTime::fromMSecsSinceEpoch(slot.msecs).toString("yyyy-MM-dd hh:mm:ss").toUtf8();
+        }
+        buffer += '[';
+        buffer += stamp;
+        buffer += "] ";
+        buffer += slot.text.toUtf8();
+        buffer += '\n';
+
+        slot.text = QString(); // don't keep the string alive in the ring
+        slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+    }
+
+    const quint64 dropped = droppedCount.load(std::memory_order_relaxed);
+    if (dropped != droppedReported) {
+        buffer += QString("[%1] Logger: %2 events dropped (buffer full)\n")
+                      .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss"))
+                      .arg(dropped - droppedReported)
+                      .toUtf8();
+        droppedReported = dropped;
+    }
+
+    if (!buffer.isEmpty() && file.isOpen()) {
+        file.write(buffer);
+        file.flush();
+    }
+    return dequeuePos;
+}
+
+bool EventLogger::hasPending() const
+{
+    return ring[dequeuePos & mask].sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+}
+
+void EventLogger::writerLoop()
+{
+    QFile file(opts.path);
+    file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+
+    QByteArray buffer;
+    buffer.reserve(16 * 1024);
+
+    bool lastPassEmpty = true;
+
+    for (;;) {
+        bool stop;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            if (lastPassEmpty) {
+                // nothing going on: sleep until log() wakes us
+                writerIdle.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                wake.wait(guard, [&] {
+                    return stopping || flushRequested || !writerIdle.load(std::memory_order_relaxed) || hasPending();
+                });
+                writerIdle.store(false, std::memory_order_relaxed);
+            } else {
+                wake.wait_for(guard, opts.flushInterval, [&] { return stopping || flushRequested; });
+            }
+            stop = stopping;
+            flushRequested = false;
+        }
+
+        const quint64 written = drain(file, buffer);
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            lastPassEmpty = written == writtenPos;
+            writtenPos = written;
+        }
+        flushed.notify_all();
+
+        if (stop) break;
+    }
+
+    file.close();
+}
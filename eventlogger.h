@@ -0,0 +1,82 @@
+#ifndef EVENTLOGGER_H
+#define EVENTLOGGER_H
+
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class QFile;
+
+// Buffered game log. log() stamps the event and drops it into a fixed
+// size lock-free ring (any thread may call it); a background thread
+// drains the ring every flushInterval, formats the lines and appends them
+// to the file in one write. The file stays open for the logger's lifetime
+// and everything queued is written before the destructor returns.
+// When a pass finds nothing to write the thread sleeps until the next
+// log(), so an idle logger costs no CPU.
+class EventLogger
+{
+public:
+    enum class OverflowPolicy {
+        DropNewest, // ring full: the event is counted and discarded, log() never waits
+        Block       // ring full: log() waits for the writer to make room
+    };
+
+    struct Options {
+        QString path = "game_log.txt";
+        int capacity = 4096;                          // rounded up to a power of two
+        std::chrono::milliseconds flushInterval{250};
+        OverflowPolicy overflow = OverflowPolicy::DropNewest;
+    };
+
+    EventLogger();
+    explicit EventLogger(const Options& options);
+    ~EventLogger();
+
+    EventLogger(const EventLogger&) = delete;
+    EventLogger& operator=(const EventLogger&) = delete;
+
+    void log(const QString& event);
+
+    // wait until everything logged before this call is in the file
+    void flush();
+
+    quint64 dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+    const Options& options() const { return opts; }
+
+private:
+    struct Slot {
+        std::atomic<quint64> sequence{0};
+        qint64 msecs = 0;
+        QString text;
+    };
+
+    void writerLoop();
+    bool hasPending() const; // writer thread only
+    quint64 drain(QFile& file, QByteArray& buffer);
+
+    Options opts;
+    std::unique_ptr<Slot[]> ring;
+    quint64 mask = 0;
+
+    alignas(64) std::atomic<quint64> enqueuePos{0};
+    alignas(64) quint64 dequeuePos = 0;                // writer thread only
+    std::atomic<quint64> droppedCount{0};
+    std::atomic<bool> writerIdle{false};               // writer is asleep until the next log()
+    quint64 droppedReported = 0;                       // writer thread only
+
+    std::mutex lock;                 // only for sleeping/waking, never taken by log()
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    quint64 writtenPos = 0;          // guarded by lock
+    bool flushRequested = false;     // guarded by lock
+    bool stopping = false;           // guarded by lock
+
+    std::thread writer;
+};
+
+#endif // EVENTLOGGER_H
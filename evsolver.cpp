@@ -0,0 +1,298 @@
+#include "evsolver.h"
+#include <algorithm>
+
+// ---------------- ShoeComposition ----------------
+
+ShoeComposition ShoeComposition::fromCards(const std::vector<Card>& cards)
+{
+    ShoeComposition comp;
+    for (Card c : cards) {
+        comp.add(c);
+    }
+    return comp;
+}
+
+std::uint64_t ShoeComposition::key() const
+{
+    // 6 bits per non-ten count (8 decks have at most 32 of each),
+    // 8 bits for tens (at most 128)
+    std::uint64_t k = 0;
+    for (int i = 0; i < 9; ++i) {
+        k |= static_cast<std::uint64_t>(counts[i] & 0x3F) << (6 * i);
+    }
+    k |= static_cast<std::uint64_t>(counts[9] & 0xFF) << 54;
+    return k;
+}
+
+ShoeComposition unseenComposition(const Table& table)
+{
+    // straight from the shoe's rank counts, no walk over the cards
+    const Shoe& shoe = table.shoe();
+    ShoeComposition comp;
+    comp.counts[0] = shoe.remainingOfRank(1);
+    for (int r = 2; r <= 9; ++r) comp.counts[r - 1] = shoe.remainingOfRank(r);
+    comp.counts[9] = shoe.remainingTens();
+    comp.total = shoe.remaining();
+
+    const Hand& dealer = table.dealerHand();
+    if (!table.holeCardRevealed() && dealer.size() > 1) {
+        comp.add(dealer[1]);
+    }
+    return comp;
+}
+
+// ---------------- ActionEV ----------------
+
+Action ActionEV::best() const
+{
+    Action action = stand >= hit ? Action::Stand : Action::Hit;
+    double value = std::max(stand, hit);
+    if (canDouble && doubleDown > value) {
+        action = Action::Double;
+        value = doubleDown;
+    }
+    if (canSurrender && surrender > value) {
+        action = Action::Surrender;
+    }
+    return action;
+}
+
+double ActionEV::bestValue() const
+{
+    double value = std::max(stand, hit);
+    if (canDouble) value = std::max(value, doubleDown);
+    if (canSurrender) value = std::max(value, surrender);
+    return value;
+}
+
+// ---------------- EvSolver ----------------
+
+namespace {
+
+int bestTotal(int hardSum, bool hasAce)
+{
+    return (hasAce && hardSum <= 11) ? hardSum + 10 : hardSum;
+}
+
+} // namespace
+
+EvSolver::EvSolver(const Rules& rules)
+    : currentRules(rules)
+{
+}
+
+void EvSolver::setRules(const Rules& rules)
+{
+    currentRules = rules;
+    clearCache();
+}
+
+void EvSolver::clearCache()
+{
+    dealerCache.clear();
+    hitCache.clear();
+}
+
+void EvSolver::trimCaches()
+{
+    if (cacheSize() > MAX_CACHE_ENTRIES) {
+        clearCache();
+    }
+}
+
+bool EvSolver::cancelled()
+{
+    if (!aborted && cancelCheck && cancelCheck()) {
+        aborted = true;
+    }
+    return aborted;
+}
+
+void EvSolver::dealerPlay(ShoeComposition& comp, int hardSum, bool hasAce, int cards, double p, DealerOutcome& out) const
+{
+    const int total = bestTotal(hardSum, hasAce);
+
+    if (cards >= 2) {
+        if (cards == 2 && total == 21) {
+            out.natural += p;
+            return;
+        }
+        if (total > 21) {
+            out.bust += p;
+            return;
+        }
+        if (total >= currentRules.dealerTarget) {
+            out.final[total - 17] += p;
+            return;
+        }
+    }
+
+    if (comp.total == 0) {
+        // nothing left to draw; can't happen with a real cut card, count it as a 17
+        out.final[0] += p;
+        return;
+    }
+
+    const double remaining = comp.total;
+    for (int i = 0; i < 10; ++i) {
+        const int n = comp.counts[i];
+        if (n == 0) continue;
+
+        comp.counts[i]--;
+        comp.total--;
+        dealerPlay(comp, hardSum + i + 1, hasAce || i == 0, cards + 1, p * n / remaining, out);
+        comp.counts[i]++;
+        comp.total++;
+    }
+}
+
+DealerOutcome EvSolver::dealerOutcome(const ShoeComposition& remaining, int upcardIndex)
+{
+    const Key key{ remaining.key(), static_cast<std::uint32_t>(upcardIndex | currentRules.dealerTarget << 4) };
+    auto it = dealerCache.find(key);
+    if (it != dealerCache.end()) return it->second;
+
+    DealerOutcome out;
+    ShoeComposition comp = remaining;
+    dealerPlay(comp, upcardIndex + 1, upcardIndex == 0, 1, 1.0, out);
+
+    trimCaches();
+    dealerCache.emplace(key, out);
+    return out;
+}
+
+double EvSolver::standValue(int hardSum, bool hasAce, bool natural, const DealerOutcome& dealer) const
+{
+    if (natural) {
+        // pays 3:2 (or whatever the rules say) unless the dealer has one too
+        const double pay = static_cast<double>(currentRules.blackjackPayNum) / currentRules.blackjackPayDen;
+        return (1.0 - dealer.natural) * pay;
+    }
+
+    const int total = bestTotal(hardSum, hasAce);
+    double ev = dealer.bust - dealer.natural;
+    for (int d = 17; d <= 21; ++d) {
+        const double p = dealer.final[d - 17];
+        if (total > d) ev += p;
+        else if (total < d) ev -= p;
+    }
+    return ev;
+}
+
+double EvSolver::hitValue(ShoeComposition& comp, int hardSum, bool hasAce, int upcardIndex)
+{
+    const Key key{ comp.key(), static_cast<std::uint32_t>(hardSum | hasAce << 6 | upcardIndex << 7) };
+    auto it = hitCache.find(key);
+    if (it != hitCache.end()) return it->second;
+    if (cancelled()) return 0.0;
+
+    double ev = 0.0;
+    const double remaining = comp.total;
+    for (int i = 0; i < 10; ++i) {
+        const int n = comp.counts[i];
+        if (n == 0) continue;
+
+        const double q = n / remaining;
+        const int newSum = hardSum + i + 1;
+        if (newSum > 21) {
+            ev -= q;
+            continue;
+        }
+
+        comp.counts[i]--;
+        comp.total--;
+        ev += q * bestAfterHit(comp, newSum, hasAce || i == 0, upcardIndex);
+        comp.counts[i]++;
+        comp.total++;
+    }
+
+    if (aborted) return 0.0; // incomplete, don't remember it
+
+    trimCaches();
+    hitCache.emplace(key, ev);
+    return ev;
+}
+
+double EvSolver::doubleValue(ShoeComposition& comp, int hardSum, bool hasAce, int upcardIndex)
+{
+    // kind bit 1 << 11 keeps these apart from plain hit values
+    const Key key{ comp.key(), static_cast<std::uint32_t>(hardSum | hasAce << 6 | upcardIndex << 7 | 1 << 11) };
+    auto it = hitCache.find(key);
+    if (it != hitCache.end()) return it->second;
+    if (cancelled()) return 0.0;
+
+    double ev = 0.0;
+    const double remaining = comp.total;
+    for (int i = 0; i < 10; ++i) {
+        const int n = comp.counts[i];
+        if (n == 0) continue;
+
+        const double q = n / remaining;
+        const int newSum = hardSum + i + 1;
+        if (newSum > 21) {
+            ev -= 2.0 * q;
+            continue;
+        }
+
+        comp.counts[i]--;
+        comp.total--;
+        ev += 2.0 * q * standValue(newSum, hasAce || i == 0, false, dealerOutcome(comp, upcardIndex));
+        comp.counts[i]++;
+        comp.total++;
+    }
+
+    if (aborted) return 0.0; // incomplete, don't remember it
+
+    trimCaches();
+    hitCache.emplace(key, ev);
+    return ev;
+}
+
+double EvSolver::bestAfterHit(ShoeComposition& comp, int hardSum, bool hasAce, int upcardIndex)
+{
+    double best = standValue(hardSum, hasAce, false, dealerOutcome(comp, upcardIndex));
+    if (bestTotal(hardSum, hasAce) == 21) return best; // nothing to gain
+
+    best = std::max(best, hitValue(comp, hardSum, hasAce, upcardIndex));
+    if (currentRules.allowDouble) {
+        // the table lets you double at any point, not just on two cards
+        best = std::max(best, doubleValue(comp, hardSum, hasAce, upcardIndex));
+    }
+    return best;
+}
+
+ActionEV EvSolver::evaluate(const Hand& player, Card upcard, const ShoeComposition& remaining, bool firstAction,
+                            bool splitHand)
+{
+    int hardSum = 0;
+    bool hasAce = false;
+    for (Card c : player) {
+        hardSum += c.isAce() ? 1 : c.value();
+        hasAce = hasAce || c.isAce();
+    }
+    const int upcardIndex = ShoeComposition::indexOf(upcard);
+    const bool natural = !splitHand && player.size() == 2 && bestTotal(hardSum, hasAce) == 21;
+    aborted = false;
+
+    ShoeComposition comp = remaining;
+    ActionEV ev;
+    ev.stand = standValue(hardSum, hasAce, natural, dealerOutcome(comp, upcardIndex));
+    ev.hit = hardSum > 21 ? -1.0 : hitValue(comp, hardSum, hasAce, upcardIndex);
+
+    ev.canDouble = currentRules.allowDouble;
+    if (ev.canDouble) {
+        ev.doubleDown = doubleValue(comp, hardSum, hasAce, upcardIndex);
+    }
+
+    ev.canSurrender = firstAction && currentRules.allowSurrender;
+    ev.surrender = -0.5;
+    return ev;
+}
+
+ActionEV EvSolver::evaluate(const Table& table)
+{
+    ActionEV ev = evaluate(table.playerHand(), table.dealerHand().front(), unseenComposition(table),
+                           table.canSurrender(), table.handCount() > 1);
+    ev.canDouble = ev.canDouble && table.canDouble();
+    return ev;
+}
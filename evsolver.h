@@ -0,0 +1,114 @@
+#ifndef EVSOLVER_H
+#define EVSOLVER_H
+
+#include "table.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// Exact, composition dependent expected values for the player's options.
+// Works by recursion over the remaining shoe counts. Dealer outcome
+// probabilities (under the table's dealer rule, no hole card peek) are
+// memoized per (composition, upcard) and player hit values per
+// (composition, hand, upcard), so asking again during the same shoe is a
+// hash lookup.
+
+// Card counts by blackjack value: index 0 = ace, 1..8 = 2..9, 9 = tens
+struct ShoeComposition {
+    std::array<int, 10> counts{};
+    int total = 0;
+
+    static int indexOf(Card card) { return card.isAce() ? 0 : card.value() - 1; }
+
+    static ShoeComposition fromCards(const std::vector<Card>& cards);
+    void add(Card card) { counts[indexOf(card)]++; total++; }
+    void remove(Card card) { counts[indexOf(card)]--; total--; }
+
+    std::uint64_t key() const;
+};
+
+// Cards the player can't see: the undealt shoe plus the dealer's hole
+// card while it is face down
+ShoeComposition unseenComposition(const Table& table);
+
+// Where the dealer ends up. final[t] is for totals 17..21 (index t - 17).
+struct DealerOutcome {
+    std::array<double, 5> final{};
+    double bust = 0.0;
+    double natural = 0.0;
+};
+
+struct ActionEV {
+    double hit = 0.0;
+    double stand = 0.0;
+    double doubleDown = 0.0;
+    double surrender = 0.0;
+    bool canDouble = false;
+    bool canSurrender = false;
+
+    Action best() const;
+    double bestValue() const;
+};
+
+class EvSolver
+{
+public:
+    explicit EvSolver(const Rules& rules = Rules());
+
+    const Rules& rules() const { return currentRules; }
+    void setRules(const Rules& rules);   // drops the caches
+
+    // EV per unit of the original bet. upcard is the dealer's face up card,
+    // remaining is everything unseen (see unseenComposition). A two card
+    // 21 on a split hand is just 21, not a natural.
+    ActionEV evaluate(const Hand& player, Card upcard, const ShoeComposition& remaining, bool firstAction,
+                      bool splitHand = false);
+    ActionEV evaluate(const Table& table);
+
+    DealerOutcome dealerOutcome(const ShoeComposition& remaining, int upcardIndex);
+
+    // Lets a caller on another thread abandon a long evaluate(). The check
+    // is polled during the recursion; once it returns true evaluate()
+    // bails out, wasCancelled() is set and nothing partial is cached.
+    void setCancelCheck(std::function<bool()> check) { cancelCheck = std::move(check); }
+    bool wasCancelled() const { return aborted; }
+
+    std::size_t cacheSize() const { return dealerCache.size() + hitCache.size(); }
+    void clearCache();
+
+    // caches are dropped when they grow past this many entries
+    static constexpr std::size_t MAX_CACHE_ENTRIES = 1 << 22;
+
+private:
+    struct Key {
+        std::uint64_t counts;
+        std::uint32_t extra;
+        bool operator==(const Key& o) const { return counts == o.counts && extra == o.extra; }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const
+        {
+            std::uint64_t h = k.counts * 0x9e3779b97f4a7c15ULL ^ (k.extra + 0x632be59bd9b4e019ULL);
+            return static_cast<std::size_t>(h ^ (h >> 29));
+        }
+    };
+
+    void dealerPlay(ShoeComposition& comp, int hardSum, bool hasAce, int cards, double p, DealerOutcome& out) const;
+    double standValue(int hardSum, bool hasAce, bool natural, const DealerOutcome& dealer) const;
+    double hitValue(ShoeComposition& comp, int hardSum, bool hasAce, int upcardIndex);
+    double bestAfterHit(ShoeComposition& comp, int hardSum, bool hasAce, int upcardIndex);
+    double doubleValue(ShoeComposition& comp, int hardSum, bool hasAce, int upcardIndex);
+    void trimCaches();
+    bool cancelled();
+
+    Rules currentRules;
+    std::unordered_map<Key, DealerOutcome, KeyHash> dealerCache;
+    std::unordered_map<Key, double, KeyHash> hitCache;
+    std::function<bool()> cancelCheck;
+    bool aborted = false;
+};
+
+#endif // EVSOLVER_H
@@ -0,0 +1,106 @@
+// blackjack_explore - house edge and variance over a grid of rule variants.
+//
+//   blackjack_explore [--rounds N] [--threads T] [--seed S] [--chunk C]
+//                     [--penetration P] [--decks 1,2,4,6,8] [--csm]
+//                     [--cache FILE | --no-cache]
+//
+// The grid is every deck count given x dealer to 17 / 18 (hard mode) x
+// surrender on / off x naturals paying 3:2 / 6:5. --rounds is per cell.
+// Cells already in the cache file (default explore_cache.txt) for the
+// same settings are not played again, so adding a deck count only plays
+// the new cells.
+
+#include "ruleexplorer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: blackjack_explore [--rounds N] [--threads T] [--seed S] [--chunk C]\n"
+                 "                         [--penetration P] [--decks 1,2,4,6,8] [--csm]\n"
+                 "                         [--cache FILE | --no-cache]\n");
+}
+
+bool parseList(const char* text, std::vector<int>& out)
+{
+    out.clear();
+    while (*text) {
+        char* end = nullptr;
+        const long v = std::strtol(text, &end, 10);
+        if (end == text || v < 1 || v > 8) return false;
+        out.push_back(static_cast<int>(v));
+        text = *end == ',' ? end + 1 : end;
+    }
+    return !out.empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    ExploreConfig config;
+    std::string cachePath = "explore_cache.txt";
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (!std::strcmp(arg, "--rounds") && hasValue) config.rounds = std::strtoll(argv[++i], nullptr, 10);
+        else if (!std::strcmp(arg, "--threads") && hasValue) config.threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--seed") && hasValue) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(arg, "--chunk") && hasValue) config.chunkRounds = std::strtoll(argv[++i], nullptr, 10);
+        else if (!std::strcmp(arg, "--penetration") && hasValue) config.base.penetration = std::atof(argv[++i]);
+        else if (!std::strcmp(arg, "--decks") && hasValue && parseList(argv[i + 1], config.decks)) ++i;
+        else if (!std::strcmp(arg, "--csm")) config.base.continuousShuffle = true;
+        else if (!std::strcmp(arg, "--cache") && hasValue) cachePath = argv[++i];
+        else if (!std::strcmp(arg, "--no-cache")) cachePath.clear();
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (config.rounds <= 0) {
+        usage();
+        return 1;
+    }
+
+    ExploreCache cache;
+    if (!cachePath.empty()) cache.load(cachePath);
+
+    const ExploreResult result = exploreRules(config, cachePath.empty() ? nullptr : &cache);
+
+    // variance per round in units of the (flat) bet
+    const double betSquared = static_cast<double>(config.bet) * config.bet;
+    std::printf("decks  dealer  surrender  payout   house edge    95%% CI   variance\n");
+    int cached = 0;
+    for (const ExploreCell& cell : result.cells) {
+        const Rules& r = cell.rules;
+        std::printf("%5d  %6d  %9s  %4d:%d  %+10.4f%%  %7.4f%%  %9.4f%s\n",
+                    r.numDecks, r.dealerTarget, r.allowSurrender ? "on" : "off",
+                    r.blackjackPayNum, r.blackjackPayDen,
+                    cell.houseEdge() * 100.0, cell.confidence95() * 100.0,
+                    cell.stats.variancePerRound() / betSquared, cell.cached ? "  (cached)" : "");
+        cached += cell.cached ? 1 : 0;
+    }
+
+    std::printf("\n%d cells, %d from the cache, %lld rounds each, seed %llu\n",
+                static_cast<int>(result.cells.size()), cached, static_cast<long long>(config.rounds),
+                static_cast<unsigned long long>(config.seed));
+    if (result.roundsPlayed > 0) {
+        std::printf("played %lld rounds on %d threads in %.2f s (%.2f M rounds/s)\n",
+                    static_cast<long long>(result.roundsPlayed), result.threads, result.seconds,
+                    result.seconds > 0 ? result.roundsPlayed / result.seconds / 1e6 : 0.0);
+    }
+
+    if (!cachePath.empty() && !cache.save(cachePath)) {
+        std::fprintf(stderr, "could not write %s\n", cachePath.c_str());
+        return 1;
+    }
+    return 0;
+}
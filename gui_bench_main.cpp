@@ -0,0 +1,137 @@
+// blackjack_bench_gui - benchmarks for the Qt side hot paths: logEvent
+// and the card display update. Runs on the offscreen platform unless
+// QT_QPA_PLATFORM says otherwise. Same options as blackjack_bench.
+
+#include "benchharness.h"
+#include "cardatlas.h"
+#include "cardview.h"
+#include "eventlogger.h"
+#include "table.h"
+#include <QApplication>
+#include <QFile>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QWidget>
+#include <vector>
+
+namespace {
+
+void benchLogEvent(BenchSuite& bench)
+{
+    const QString path = "bench_game_log.txt";
+    const int n = 20000;
+    {
+        EventLogger::Options options;
+        options.path = path;
+        options.capacity = 1 << 16;
+        options.overflow = EventLogger::OverflowPolicy::Block; // every event really gets written
+        EventLogger log(options);
+
+        // what MainWindow::logEvent costs the GUI thread, formatting included
+        bench.run("log_event", n, 5, [&] {
+            for (int i = 0; i < n; ++i) log.log(QString("Bet placed: $%1").arg(i));
+        });
+
+        // the same, waiting until it is in the file
+        bench.run("log_event_written", n, 3, [&] {
+            for (int i = 0; i < n; ++i) log.log(QString("Bet placed: $%1").arg(i));
+            log.flush();
+        });
+
+        if (log.dropped() != 0) bench.fail("logger dropped events");
+    }
+    QFile::remove(path);
+}
+
+// one step of a round as the table shows it
+struct TableState {
+    Hand player;
+    Hand dealer;
+    bool hideHole;
+};
+
+std::vector<TableState> recordStates(int rounds)
+{
+    std::vector<TableState> states;
+    Table table;
+    table.seed(17);
+    table.setBalance(1000000);
+
+    auto capture = [&] { states.push_back(TableState{ table.playerHand(), table.dealerHand(), !table.holeCardRevealed() }); };
+
+    for (int r = 0; r < rounds; ++r) {
+        table.placeBet(10);
+        table.dealInitialCards();
+        capture();
+        while (table.playerValue() < 17) {
+            table.hit();
+            capture();
+        }
+        if (table.playerValue() > 21) {
+            table.endRound();
+            capture();
+            continue;
+        }
+        table.revealHoleCard();
+        capture();
+        while (table.dealerShouldDraw()) {
+            table.dealerDraw();
+            capture();
+        }
+        table.endRound();
+    }
+    return states;
+}
+
+void benchCardDisplays(BenchSuite& bench)
+{
+    CardAtlas::warmUp(QSize(80, 120), 1.0);
+
+    QWidget host;
+    auto* layout = new QVBoxLayout(&host);
+    auto* dealerLayout = new QHBoxLayout();
+    auto* playerLayout = new QHBoxLayout();
+    layout->addLayout(dealerLayout);
+    layout->addLayout(playerLayout);
+    host.resize(900, 300);
+    host.show();
+
+    CardViewPool pool;
+    QVector<CardView*> dealerViews;
+    QVector<CardView*> playerViews;
+    const std::vector<TableState> states = recordStates(500);
+
+    // MainWindow::updateCardDisplays for every step of 500 rounds
+    bench.run("update_card_displays", states.size(), 5, [&] {
+        for (const TableState& s : states) {
+            pool.sync(dealerLayout, dealerViews, s.dealer, s.hideHole);
+            pool.sync(playerLayout, playerViews, s.player, false);
+        }
+    });
+
+    // the same with the layout and repaint that follow each update
+    bench.run("update_card_displays_painted", states.size(), 3, [&] {
+        for (const TableState& s : states) {
+            pool.sync(dealerLayout, dealerViews, s.dealer, s.hideHole);
+            pool.sync(playerLayout, playerViews, s.player, false);
+            QApplication::processEvents();
+        }
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    BenchSuite bench("blackjack_bench_gui");
+    if (!bench.parseArgs(argc, argv)) return 2;
+
+    benchLogEvent(bench);
+    benchCardDisplays(bench);
+    return bench.finish();
+}
@@ -0,0 +1,106 @@
+#ifndef HAND_H
+#define HAND_H
+
+#include "card.h"
+#include <cstdint>
+#include <initializer_list>
+
+// A hand of cards, stored inline. Capacity is fixed (nobody holds more
+// than MAX_CARDS without busting: 21 aces plus the card that breaks
+// them), so copying, dealing and settling hands never allocates. The
+// total and whether an ace still counts 11 are kept up to date as cards
+// are added, so value() and isSoft() are O(1).
+//
+// The interface is the bit of std::vector the engine and the UI use.
+class Hand
+{
+public:
+    static constexpr int MAX_CARDS = 24;
+
+    using value_type = Card;
+    using const_iterator = const Card*;
+
+    Hand() = default;
+    Hand(std::initializer_list<Card> list)
+    {
+        for (Card c : list) push_back(c);
+    }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    static constexpr int capacity() { return MAX_CARDS; }
+
+    const Card* data() const { return cards; }
+    const Card& operator[](int i) const { return cards[i]; }
+    const Card& front() const { return cards[0]; }
+    const Card& back() const { return cards[count - 1]; }
+    const Card* begin() const { return cards; }
+    const Card* end() const { return cards + count; }
+
+    // full hands drop the card; only a corrupt save could get there
+    void push_back(Card c)
+    {
+        if (count == MAX_CARDS) return;
+        cards[count++] = c;
+        hardTotal += c.isAce() ? 1 : c.value();
+        hasAce = hasAce || c.isAce();
+    }
+
+    Card pop_back()
+    {
+        const Card c = cards[--count];
+        recount();
+        return c;
+    }
+
+    void clear()
+    {
+        count = 0;
+        hardTotal = 0;
+        hasAce = false;
+    }
+
+    // false (and the hand left empty) if n is more than a hand can hold
+    bool assign(const Card* first, int n)
+    {
+        clear();
+        if (n < 0 || n > MAX_CARDS) return false;
+        for (int i = 0; i < n; ++i) cards[i] = first[i];
+        count = static_cast<std::uint8_t>(n);
+        recount();
+        return true;
+    }
+
+    // best total: one ace counts 11 if that doesn't bust the hand
+    int value() const { return isSoft() ? hardTotal + 10 : hardTotal; }
+    bool isSoft() const { return hasAce && hardTotal + 10 <= 21; }
+    int hardValue() const { return hardTotal; } // every ace as 1
+
+    bool operator==(const Hand& o) const
+    {
+        if (count != o.count) return false;
+        for (int i = 0; i < count; ++i) {
+            if (cards[i] != o.cards[i]) return false;
+        }
+        return true;
+    }
+    bool operator!=(const Hand& o) const { return !(*this == o); }
+
+private:
+    void recount()
+    {
+        hardTotal = 0;
+        hasAce = false;
+        for (int i = 0; i < count; ++i) {
+            hardTotal += cards[i].isAce() ? 1 : cards[i].value();
+            hasAce = hasAce || cards[i].isAce();
+        }
+    }
+
+    Card cards[MAX_CARDS];
+    std::uint8_t count = 0;
+    std::uint8_t hardTotal = 0;
+    bool hasAce = false;
+};
+
+#endif // HAND_H
@@ -0,0 +1,172 @@
+#include "handeval.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HANDEVAL_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HANDEVAL_SSE2 1
+#endif
+
+// With aces counted as 1, at most one ace can ever be worth 11, and it is
+// exactly when hardSum + 10 <= 21. That is what handValue() ends up with
+// after demoting aces one by one, so:
+//   soft    = aces > 0 && hardSum <= 11
+//   total   = hardSum + (soft ? 10 : 0)
+//   bust    = total > 21
+//   natural = cards == 2 && total == 21
+
+void HandBatch::clear()
+{
+    hardSum.clear();
+    aces.clear();
+    cardCount.clear();
+}
+
+void HandBatch::reserve(std::size_t n)
+{
+    hardSum.reserve(n);
+    aces.reserve(n);
+    cardCount.reserve(n);
+}
+
+void HandBatch::add(const Hand& hand)
+{
+    int sum = 0;
+    int aceCount = 0;
+    for (const Card& card : hand) {
+        sum += card.isAce() ? 1 : card.value();
+        aceCount += card.isAce();
+    }
+    hardSum.push_back(static_cast<std::uint8_t>(sum));
+    aces.push_back(static_cast<std::uint8_t>(aceCount));
+    cardCount.push_back(static_cast<std::uint8_t>(hand.size()));
+}
+
+namespace {
+
+void prepare(const HandBatch& hands, HandBatchResult& out)
+{
+    const std::size_t words = (hands.size() + 31) / 32;
+    out.total.resize(hands.size());
+    out.softMask.assign(words, 0);
+    out.bustMask.assign(words, 0);
+    out.naturalMask.assign(words, 0);
+}
+
+void scalarRange(const HandBatch& hands, HandBatchResult& out, std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; ++i) {
+        const int sum = hands.hardSum[i];
+        const bool soft = hands.aces[i] > 0 && sum <= 11;
+        const int total = sum + (soft ? 10 : 0);
+        const std::uint32_t bit = 1u << (i % 32);
+
+        out.total[i] = static_cast<std::uint8_t>(total);
+        if (soft) out.softMask[i / 32] |= bit;
+        if (total > 21) out.bustMask[i / 32] |= bit;
+        if (total == 21 && hands.cardCount[i] == 2) out.naturalMask[i / 32] |= bit;
+    }
+}
+
+} // namespace
+
+void evaluateHandsScalar(const HandBatch& hands, HandBatchResult& out)
+{
+    prepare(hands, out);
+    scalarRange(hands, out, 0, hands.size());
+}
+
+#if HANDEVAL_AVX2
+
+void evaluateHands(const HandBatch& hands, HandBatchResult& out)
+{
+    prepare(hands, out);
+
+    const std::size_t n = hands.size();
+    const std::size_t vectorEnd = n - n % 32;
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i eleven = _mm256_set1_epi8(11);
+    const __m256i ten = _mm256_set1_epi8(10);
+    const __m256i twentyOne = _mm256_set1_epi8(21);
+    const __m256i two = _mm256_set1_epi8(2);
+
+    for (std::size_t i = 0; i < vectorEnd; i += 32) {
+        const __m256i sum = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&hands.hardSum[i]));
+        const __m256i aces = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&hands.aces[i]));
+        const __m256i cards = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&hands.cardCount[i]));
+
+        // unsigned a <= b  <=>  min(a, b) == a
+        const __m256i hasAce = _mm256_andnot_si256(_mm256_cmpeq_epi8(aces, zero), _mm256_set1_epi8(-1));
+        const __m256i lowSum = _mm256_cmpeq_epi8(_mm256_min_epu8(sum, eleven), sum);
+        const __m256i soft = _mm256_and_si256(hasAce, lowSum);
+        const __m256i total = _mm256_add_epi8(sum, _mm256_and_si256(soft, ten));
+        const __m256i notBust = _mm256_cmpeq_epi8(_mm256_min_epu8(total, twentyOne), total);
+        const __m256i natural = _mm256_and_si256(_mm256_cmpeq_epi8(total, twentyOne),
+                                                 _mm256_cmpeq_epi8(cards, two));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&out.total[i]), total);
+        out.softMask[i / 32] = static_cast<std::uint32_t>(_mm256_movemask_epi8(soft));
+        out.bustMask[i / 32] = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(notBust));
+        out.naturalMask[i / 32] = static_cast<std::uint32_t>(_mm256_movemask_epi8(natural));
+    }
+
+    scalarRange(hands, out, vectorEnd, n);
+}
+
+const char* handEvalKernelName() { return "avx2"; }
+
+#elif HANDEVAL_SSE2
+
+void evaluateHands(const HandBatch& hands, HandBatchResult& out)
+{
+    prepare(hands, out);
+
+    const std::size_t n = hands.size();
+    const std::size_t vectorEnd = n - n % 16;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i eleven = _mm_set1_epi8(11);
+    const __m128i ten = _mm_set1_epi8(10);
+    const __m128i twentyOne = _mm_set1_epi8(21);
+    const __m128i two = _mm_set1_epi8(2);
+
+    for (std::size_t i = 0; i < vectorEnd; i += 16) {
+        const __m128i sum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&hands.hardSum[i]));
+        const __m128i aces = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&hands.aces[i]));
+        const __m128i cards = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&hands.cardCount[i]));
+
+        // unsigned a <= b  <=>  min(a, b) == a
+        const __m128i hasAce = _mm_andnot_si128(_mm_cmpeq_epi8(aces, zero), _mm_set1_epi8(-1));
+        const __m128i lowSum = _mm_cmpeq_epi8(_mm_min_epu8(sum, eleven), sum);
+        const __m128i soft = _mm_and_si128(hasAce, lowSum);
+        const __m128i total = _mm_add_epi8(sum, _mm_and_si128(soft, ten));
+        const __m128i notBust = _mm_cmpeq_epi8(_mm_min_epu8(total, twentyOne), total);
+        const __m128i natural = _mm_and_si128(_mm_cmpeq_epi8(total, twentyOne),
+                                              _mm_cmpeq_epi8(cards, two));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&out.total[i]), total);
+
+        // two 16 lane blocks fill one 32 bit mask word
+        const int shift = static_cast<int>(i % 32);
+        out.softMask[i / 32] |= static_cast<std::uint32_t>(_mm_movemask_epi8(soft)) << shift;
+        out.bustMask[i / 32] |= (~static_cast<std::uint32_t>(_mm_movemask_epi8(notBust)) & 0xFFFFu) << shift;
+        out.naturalMask[i / 32] |= static_cast<std::uint32_t>(_mm_movemask_epi8(natural)) << shift;
+    }
+
+    scalarRange(hands, out, vectorEnd, n);
+}
+
+const char* handEvalKernelName() { return "sse2"; }
+
+#else
+
+void evaluateHands(const HandBatch& hands, HandBatchResult& out)
+{
+    evaluateHandsScalar(hands, out);
+}
+
+const char* handEvalKernelName() { return "scalar"; }
+
+#endif
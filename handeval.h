@@ -0,0 +1,52 @@
+#ifndef HANDEVAL_H
+#define HANDEVAL_H
+
+#include "table.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Batched hand evaluation. Hands are stored as a structure of arrays
+// (sum with aces counted as 1, ace count, card count) and evaluated 32
+// (AVX2) or 16 (SSE2) at a time. Results match handValue() exactly.
+//
+// The simulator's round loop doesn't use it: every decision needs the
+// value of the hand just dealt, so there is never a batch to hand over,
+// and Hand keeps its total as cards are added, so value() is already a
+// couple of loads. This is for bulk work over stored hands (bench_main
+// checks it against handValue and times it).
+//
+// The AVX2 kernel is compiled in when the build targets AVX2
+// (BLACKJACK_AVX2 in CMake), otherwise SSE2 on x86 and plain C++
+// everywhere else.
+
+struct HandBatch {
+    std::vector<std::uint8_t> hardSum;   // aces count 1
+    std::vector<std::uint8_t> aces;
+    std::vector<std::uint8_t> cardCount;
+
+    std::size_t size() const { return hardSum.size(); }
+    void clear();
+    void reserve(std::size_t n);
+    void add(const Hand& hand);
+};
+
+struct HandBatchResult {
+    std::vector<std::uint8_t> total;          // same as handValue()
+    // one bit per hand, hand i is bit (i % 32) of word (i / 32)
+    std::vector<std::uint32_t> softMask;
+    std::vector<std::uint32_t> bustMask;
+    std::vector<std::uint32_t> naturalMask;
+
+    bool soft(std::size_t i) const { return softMask[i / 32] >> (i % 32) & 1u; }
+    bool bust(std::size_t i) const { return bustMask[i / 32] >> (i % 32) & 1u; }
+    bool natural(std::size_t i) const { return naturalMask[i / 32] >> (i % 32) & 1u; }
+};
+
+void evaluateHands(const HandBatch& hands, HandBatchResult& out);
+void evaluateHandsScalar(const HandBatch& hands, HandBatchResult& out);
+
+// "avx2", "sse2" or "scalar"
+const char* handEvalKernelName();
+
+#endif // HANDEVAL_H
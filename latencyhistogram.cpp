@@ -0,0 +1,87 @@
+#include "latencyhistogram.h"
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+int highestBit(std::uint64_t v) // v != 0
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, v);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+} // namespace
+
+int LatencyHistogram::bucketOf(std::uint64_t value)
+{
+    if (value < SUB_COUNT) return static_cast<int>(value);
+
+    // exponent picks the power of two, the next SUB_BITS bits the slot in it
+    const int exponent = std::min(highestBit(value), MAX_EXPONENT);
+    const int shift = exponent - SUB_BITS;
+    const int sub = static_cast<int>((value >> shift) & (SUB_COUNT - 1));
+    const int bucket = SUB_COUNT + shift * SUB_COUNT + sub;
+    return std::min(bucket, BUCKETS - 1);
+}
+
+std::uint64_t LatencyHistogram::bucketUpper(int bucket)
+{
+    if (bucket < SUB_COUNT) return static_cast<std::uint64_t>(bucket);
+
+    const int shift = (bucket - SUB_COUNT) / SUB_COUNT;
+    const std::uint64_t sub = static_cast<std::uint64_t>((bucket - SUB_COUNT) % SUB_COUNT);
+    const std::uint64_t lower = (SUB_COUNT + sub) << shift;
+    return lower + (std::uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::int64_t ns)
+{
+    if (ns < 0) ns = 0;
+    ++counts[bucketOf(static_cast<std::uint64_t>(ns))];
+
+    if (total == 0 || ns < minValue) minValue = ns;
+    if (ns > maxValue) maxValue = ns;
+    ++total;
+    sum += static_cast<std::uint64_t>(ns);
+}
+
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram();
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    if (other.total == 0) return;
+    for (int i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+    minValue = total ? std::min(minValue, other.minValue) : other.minValue;
+    maxValue = std::max(maxValue, other.maxValue);
+    total += other.total;
+    sum += other.sum;
+}
+
+std::int64_t LatencyHistogram::percentile(double p) const
+{
+    if (total == 0) return 0;
+
+    const double clamped = std::clamp(p, 0.0, 100.0);
+    std::uint64_t rank = static_cast<std::uint64_t>(clamped / 100.0 * total + 0.5);
+    if (rank < 1) rank = 1;
+
+    std::uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(static_cast<std::int64_t>(bucketUpper(i)), maxValue);
+        }
+    }
+    return maxValue;
+}
@@ -0,0 +1,64 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+// HDR style latency histogram: log-linear buckets, 16 per power of two,
+// so any recorded value is off by at most ~6% and recording is a couple
+// of shifts and an increment. Cheap enough to leave on everywhere.
+// Values are nanoseconds; one histogram belongs to one thread.
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    static constexpr int MAX_EXPONENT = 44;   // up to ~4.8 hours in ns
+    static constexpr int BUCKETS = SUB_COUNT + (MAX_EXPONENT - SUB_BITS + 1) * SUB_COUNT;
+
+    void record(std::int64_t ns);
+    void reset();
+    void merge(const LatencyHistogram& other);
+
+    std::uint64_t count() const { return total; }
+    std::int64_t min() const { return total ? minValue : 0; }
+    std::int64_t max() const { return maxValue; }
+    double mean() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+    // upper edge of the bucket holding the p'th percentile (p in 0..100)
+    std::int64_t percentile(double p) const;
+
+    static int bucketOf(std::uint64_t value);
+    static std::uint64_t bucketUpper(int bucket);
+
+private:
+    std::array<std::uint64_t, BUCKETS> counts{};
+    std::uint64_t total = 0;
+    std::uint64_t sum = 0;
+    std::int64_t minValue = 0;
+    std::int64_t maxValue = 0;
+};
+
+// Records the time from construction to destruction
+class LatencyProbe
+{
+public:
+    explicit LatencyProbe(LatencyHistogram& histogram)
+        : histogram(histogram), start(std::chrono::steady_clock::now())
+    {
+    }
+    ~LatencyProbe()
+    {
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    LatencyProbe(const LatencyProbe&) = delete;
+    LatencyProbe& operator=(const LatencyProbe&) = delete;
+
+private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -1,18 +1,83 @@
 #include <QApplication>
 #include <QSurfaceFormat>
+#include <QTimer>
+#include <cstdlib>
+#include <cstring>
 #include "welcome.h"
 #include "mainwindow.h"
+#include "multitablewindow.h"
+#include "trace.h"
+#include "strategytablefile.h"
+
+// Tracing is opt-in: --trace FILE or BLACKJACK_TRACE=FILE writes a Chrome
+// trace (chrome://tracing, ui.perfetto.dev) of startup and every slot.
+static void startTracing(int argc, char *argv[])
+{
+    const char* path = std::getenv("BLACKJACK_TRACE");
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (!std::strcmp(argv[i], "--trace")) path = argv[i + 1];
+    }
+    if (path && *path) {
+        Trace::nameThread("GUI");
+        Trace::start(path);
+    }
+}
+
+// --tables N opens N independent tables (easy mode, no setup wizard);
+// --decks D picks the shoe size for them
+static int intOption(int argc, char *argv[], const char* name, int fallback)
+{
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (!std::strcmp(argv[i], name)) return std::atoi(argv[i + 1]);
+    }
+    return fallback;
+}
 
 int main(int argc, char *argv[])
 {
+    startTracing(argc, argv);
+
+    const std::int64_t appStart = Trace::nowMicros();
     QApplication app(argc, argv);
+    if (Trace::enabled()) Trace::complete("QApplication", "startup", appStart, Trace::nowMicros() - appStart);
+
+    {
+        // written next to the executable by blackjack_tablegen; without it
+        // the advisor builds each table the first time it's needed
+        TRACE_SCOPE("strategy tables", "startup");
+        const QString path = QCoreApplication::applicationDirPath() + "/" + StrategyTableFile::DEFAULT_NAME;
+        StrategyTableFile::shared().open(path.toStdString());
+    }
+
+    const int tables = intOption(argc, argv, "--tables", 0);
+    if (tables > 0) {
+        MultiTableWindow w(tables, qBound(1, intOption(argc, argv, "--decks", 6), 8));
+        w.show();
+        const int result = app.exec();
+        Trace::stop();
+        return result;
+    }
 
     Welcome welcome;
-    if (welcome.exec() == QDialog::Accepted) {
+    int accepted;
+    {
+        TRACE_SCOPE("Welcome::exec", "startup"); // includes the player clicking through the wizard
+        accepted = welcome.exec();
+    }
+
+    if (accepted == QDialog::Accepted) {
         MainWindow w;
-        w.show();
-        return app.exec();
+        {
+            TRACE_SCOPE("MainWindow::show", "startup");
+            w.show();
+        }
+        // first pass through the event loop: window is up and the game responds
+        QTimer::singleShot(0, [] { Trace::instant("ready", "startup"); });
+        const int result = app.exec();
+        Trace::stop();
+        return result;
     }
 
+    Trace::stop();
     return 0;
 }
@@ -1,28 +1,49 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "cardatlas.h"
+#include "trace.h"
 #include <algorithm>
+#include <QComboBox>
 #include <QPushButton>
+#include <QShortcut>
+#include <QStatusBar>
 #include <QDebug>
 #include <QDateTime>
 #include <QDirIterator>
 #include <cstdlib>
+#include <climits>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , balance(1)
-    , currentBet(0)
     , difficulty(Difficulty::Easy)
-    , gameInProgress(false)
+    , advisor(new StrategyAdvisor(this))
+    , perfOverlay(nullptr)
 {
-    ui->setupUi(this);
+    TRACE_SCOPE("MainWindow::MainWindow", "startup");
+    {
+        TRACE_SCOPE("MainWindow::setupUi", "startup");
+        ui->setupUi(this);
+    }
+    {
+        TRACE_SCOPE("CardAtlas::warmUp", "startup");
+        CardAtlas::warmUp(QSize(80, 120), devicePixelRatioF()); // card faces are painted once, up front
+    }
+    setupHandFrames();
+    table.setBackgroundShuffle(true); // next shoe is ready by the time the cut card comes out
+    connect(advisor, &StrategyAdvisor::adviceReady, this, &MainWindow::showAdvice);
+
+    // Seed the table and start recording before anything touches it
+    startSessionRecording();
 
     // Load settings (difficulty only - no file operations)
     loadSettings();
-    logEvent(QString("Game started - Difficulty: %1, Balance: $%2").arg(static_cast<int>(difficulty)).arg(balance));
+    logEvent(QString("Game started - Difficulty: %1, Balance: $%2").arg(static_cast<int>(difficulty)).arg(table.balance()));
 
-    // Initialize game state
-    initializeGame();
+    // Pick up an autosaved game if there is one, otherwise set up a new one
+    if (!restoreAutosave()) {
+        initializeGame();
+    }
 
     // Connect buttons
     connect(ui->pushButton, &QPushButton::clicked, this, &MainWindow::startNewGame);
@@ -36,156 +57,113 @@ MainWindow::MainWindow(QWidget *parent)
     if (auto b = this->findChild<QPushButton*>("saveButton")) connect(b, &QPushButton::clicked, this, &MainWindow::onSaveButtonClicked);
     if (auto b = this->findChild<QPushButton*>("loadButton")) connect(b, &QPushButton::clicked, this, &MainWindow::onLoadButtonClicked);
     if (auto b = this->findChild<QPushButton*>("surrenderButton")) connect(b, &QPushButton::clicked, this, &MainWindow::surrender);
+    if (auto b = this->findChild<QPushButton*>("hintsButton")) connect(b, &QPushButton::toggled, this, &MainWindow::onHintsToggled);
+
+    // Dealer draws one card per tick (see stand())
+    dealerTimer.setSingleShot(true);
+    connect(&dealerTimer, &QTimer::timeout, this, &MainWindow::dealerStep);
+    connect(ui->dealerSpeedBox, &QComboBox::currentIndexChanged, this, &MainWindow::onDealerSpeedChanged);
+    connect(ui->countSystemBox, &QComboBox::currentIndexChanged, this, &MainWindow::onCountSystemChanged);
+
+    // Debug overlay with the latency histograms
+    perfOverlay = new PerfOverlay(this);
+    perfOverlay->addSource("hit", &latency[MetricHit]);
+    perfOverlay->addSource("stand", &latency[MetricStand]);
+    perfOverlay->addSource("doubleDown", &latency[MetricDoubleDown]);
+    perfOverlay->addSource("placeBet", &latency[MetricPlaceBet]);
+    perfOverlay->addSource("surrender", &latency[MetricSurrender]);
+    perfOverlay->addSource("updateUI", &latency[MetricUpdateUI]);
+    perfOverlay->addSource("updateCardDisplays", &latency[MetricUpdateCardDisplays]);
+    connect(new QShortcut(QKeySequence(Qt::Key_F12), this), &QShortcut::activated, perfOverlay, &PerfOverlay::toggle);
+    connect(new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_F12), this), &QShortcut::activated, this, &MainWindow::dumpLatency);
 }
 
 MainWindow::~MainWindow()
 {
+    writeSessionRecording();
     clearCardDisplays();
     delete ui;
 }
 
 // ---------------- Helper Functions ----------------
 
-QString MainWindow::suitToSymbol(MainWindow::Card::Suit suit)
-{
-    switch (suit) {
-    case Card::Hearts:   return "♥";
-    case Card::Diamonds: return "♦";
-    case Card::Clubs:    return "♣";
-    case Card::Spades:   return "♠";
-    }
-    return "";
-}
-
-QWidget* MainWindow::createCardWidget(const MainWindow::Card& card)
-{
-    QWidget* cardWidget = new QWidget();
-    cardWidget->setMinimumSize(80, 120);
-    cardWidget->setMaximumSize(80, 120);
-
-    // Base style (dark gray background)
-    cardWidget->setStyleSheet(
-        "background-color: #2a2a2a;"
-        "border: 2px solid #b39700;"
-        "border-radius: 8px;"
-        );
-
-    // Suit color
-    QString color = (card.suit == Card::Hearts || card.suit == Card::Diamonds) ? "red" : "white";
-
-    // Top-left rank + suit
-    QLabel* topLabel = new QLabel(card.rank + suitToSymbol(card.suit), cardWidget);
-    topLabel->setStyleSheet(QString("color: %1; font: bold 14px;").arg(color));
-    topLabel->move(6, 4);
-
-    // Bottom-right rank + suit
-    QLabel* bottomLabel = new QLabel(card.rank + suitToSymbol(card.suit), cardWidget);
-    bottomLabel->setStyleSheet(QString("color: %1; font: bold 14px;").arg(color));
-    bottomLabel->adjustSize();
-    bottomLabel->move(cardWidget->width() - bottomLabel->width() - 6,
-                      cardWidget->height() - bottomLabel->height() - 6);
-
-    // Center suit only
-    QLabel* centerLabel = new QLabel(suitToSymbol(card.suit), cardWidget);
-    centerLabel->setStyleSheet(QString("color: %1; font: bold 28px;").arg(color));
-    centerLabel->adjustSize();
-    centerLabel->move((cardWidget->width() - centerLabel->width()) / 2,
-                      (cardWidget->height() - centerLabel->height()) / 2);
-
-    return cardWidget;
-}
-
-QWidget* MainWindow::createBackCardWidget()
-{
-    QWidget* cardWidget = new QWidget();
-    cardWidget->setMinimumSize(80, 120);
-    cardWidget->setMaximumSize(80, 120);
-    cardWidget->setStyleSheet(
-        "background-color: #1d3557;"
-        "border: 2px solid #b39700;"
-        "border-radius: 8px;"
-        );
-    QLabel* pattern = new QLabel("◆◇◆", cardWidget);
-    pattern->setStyleSheet("color: #a8dadc; font: bold 22px;");
-    pattern->adjustSize();
-    pattern->move((cardWidget->width() - pattern->width()) / 2,
-                  (cardWidget->height() - pattern->height()) / 2);
-    return cardWidget;
-}
-
-
 void MainWindow::clearCardDisplays()
 {
     // Clear dealer cards
-    for (QWidget* card : dealerCardWidgets) {
+    for (CardView* card : dealerCardWidgets) {
         ui->dealerCardLayout->removeWidget(card);
-        delete card;
+        cardPool.release(card);
     }
     dealerCardWidgets.clear();
 
     // Clear player cards
-    for (QWidget* card : playerCardWidgets) {
-        ui->playerCardLayout->removeWidget(card);
-        delete card;
+    for (int i = 0; i < MAX_HANDS; ++i) {
+        for (CardView* card : playerCardWidgets[i]) {
+            handLayouts[i]->removeWidget(card);
+            cardPool.release(card);
+        }
+        playerCardWidgets[i].clear();
     }
-    playerCardWidgets.clear();
 }
 
-void MainWindow::updateCardDisplays()
+void MainWindow::setupHandFrames()
 {
-    clearCardDisplays();
-
-    // Add dealer cards
-    if (!dealerHand.isEmpty()) {
-        // Always show first card
-        QWidget* first = createCardWidget(dealerHand.first());
-        dealerCardWidgets.append(first);
-        ui->dealerCardLayout->addWidget(first);
-
-        // Second card hidden unless reveal flag set
-        if (dealerHand.size() > 1) {
-            QWidget* second = revealDealerHoleCard ? createCardWidget(dealerHand[1]) : createBackCardWidget();
-            dealerCardWidgets.append(second);
-            ui->dealerCardLayout->addWidget(second);
-        }
-        // Rest of cards (if any)
-        for (int i = 2; i < dealerHand.size(); ++i) {
-            QWidget* w = createCardWidget(dealerHand[i]);
-            dealerCardWidgets.append(w);
-            ui->dealerCardLayout->addWidget(w);
-        }
+    // One frame per hand inside the player area; only the first shows
+    // until the player splits, and the hand being played gets a gold edge
+    for (int i = 0; i < MAX_HANDS; ++i) {
+        handFrames[i] = new QFrame();
+        handFrames[i]->setObjectName("handFrame");
+        handFrames[i]->setStyleSheet("#handFrame { border: 2px solid transparent; border-radius: 6px; }");
+        handLayouts[i] = new QHBoxLayout(handFrames[i]);
+        handLayouts[i]->setSpacing(10);
+        handLayouts[i]->setContentsMargins(4, 4, 4, 4);
+        ui->playerCardLayout->addWidget(handFrames[i]);
+        handFrames[i]->setVisible(i == 0);
     }
+}
 
-    // Add player cards
-    for (const Card& card : playerHand) {
-        QWidget* cardWidget = createCardWidget(card);
-        playerCardWidgets.append(cardWidget);
-        ui->playerCardLayout->addWidget(cardWidget);
+void MainWindow::updateCardDisplays()
+{
+    LatencyProbe probe(latency[MetricUpdateCardDisplays]);
+    // Only cards that changed get touched (see CardViewPool::sync)
+    cardPool.sync(ui->dealerCardLayout, dealerCardWidgets, table.dealerHand(), !table.holeCardRevealed());
+
+    static const Hand noCards;
+    const bool split = table.handCount() > 1;
+    for (int i = 0; i < MAX_HANDS; ++i) {
+        const bool inUse = i < table.handCount();
+        cardPool.sync(handLayouts[i], playerCardWidgets[i], inUse ? table.playerHand(i) : noCards, false);
+        handFrames[i]->setVisible(inUse);
+
+        const bool highlight = split && i == table.activeHand();
+        if (handFrames[i]->property("highlighted").toBool() != highlight) {
+            handFrames[i]->setProperty("highlighted", highlight);
+            handFrames[i]->setStyleSheet(highlight ? "#handFrame { border: 2px solid #FFD700; border-radius: 6px; }"
+                                                   : "#handFrame { border: 2px solid transparent; border-radius: 6px; }");
+        }
     }
 }
 
 void MainWindow::enableGameButtons(bool enabled)
 {
-    ui->hitButton->setEnabled(enabled);
+    ui->hitButton->setEnabled(enabled && table.canHit());
     ui->standButton->setEnabled(enabled);
-    ui->doubleButton->setEnabled(enabled && balance >= currentBet); // bool logic [ if balance more then current allow ]
-    ui->splitButton->setEnabled(enabled && playerHand.size() == 2 &&
-                                playerHand[0].rank == playerHand[1].rank &&
-                                balance >= currentBet);
+    ui->doubleButton->setEnabled(enabled && table.canDouble()); // bool logic [ if balance more then current allow ]
+    ui->splitButton->setEnabled(enabled && table.canSplit()); // a pair, fewer than 4 hands, and the balance for another bet
     if (auto b = this->findChild<QPushButton*>("surrenderButton")) {
-        b->setEnabled(enabled && canSurrender);
+        b->setEnabled(enabled && table.canSurrender());
     }
-    // bool logic [ if inital 2 cards and both same allow]
 }
 
 // ---------------- Core Functions ----------------
 
 void MainWindow::loadSettings()
 {
+    TRACE_SCOPE("MainWindow::loadSettings", "startup");
     QFile file("settings.txt");
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         difficulty = Difficulty::Easy;
-        balance = DEFAULT_BALANCE;
+        table.setBalance(DEFAULT_BALANCE);
         return;
     }
 
@@ -196,16 +174,16 @@ void MainWindow::loadSettings()
     if (diff == 1) { // Normal
         difficulty = Difficulty::Normal;
         in >> folderPath;
-        balance = DEFAULT_BALANCE;
+        table.setBalance(DEFAULT_BALANCE);
     }
     else if (diff == 2) { // Hard
         difficulty = Difficulty::Hard;
         folderPath = "C:/Windows/System32";
-        balance = countFilesInFolder(folderPath);
+        table.setBalance(countFilesInFolder(folderPath));
     }
     else { // Easy
         difficulty = Difficulty::Easy;
-        balance = 10000;
+        table.setBalance(DEFAULT_BALANCE);
     }
 
     file.close();
@@ -214,17 +192,13 @@ void MainWindow::loadSettings()
 
 void MainWindow::initializeGame()
 {
+    TRACE_SCOPE("MainWindow::initializeGame", "startup");
     // Initialize game state
-    dealerHand.clear();
-    playerHand.clear();
-    currentBet = 0;
-    gameInProgress = false;
-    shuffleDeck();
     clearCardDisplays();
 
     // Initialize UI elements
-    ui->balanceLabel->setText("Balance: $" + QString::number(balance));
-    ui->betLabel->setText("Current bet: $" + QString::number(currentBet));
+    ui->balanceLabel->setText("Balance: $" + QString::number(table.balance()));
+    ui->betLabel->setText("Current bet: $" + QString::number(table.currentBet()));
     ui->gameStatusLabel->setText("Place Your Bet!");
     ui->gameStatusLabel->setStyleSheet("color: #FFD700;");
     ui->playerLabel->setText("Player's Hand");
@@ -237,200 +211,120 @@ void MainWindow::initializeGame()
     bool ok;
     QStringList options = {"1", "2", "4", "6", "8"};
 
-    QString choice = QInputDialog::getItem(
-        this,
-        "Choose Deck Count",
-        "How many decks do you want to play with? (default = 1)",
-        options,
-        0,
-        false,
-        &ok
-        );
-
-    if (ok) {
-        numDecks = choice.toInt();
-    } else {
-        numDecks = 1;
+    QString choice;
+    {
+        TRACE_SCOPE("deck count dialog", "startup"); // waits for the player
+        choice = QInputDialog::getItem(
+            this,
+            "Choose Deck Count",
+            "How many decks do you want to play with? (default = 1)",
+            options,
+            0,
+            false,
+            &ok
+            );
     }
 
-    shuffleDeck(); // shuffle and create the appropriate ammount of decks
+    int numDecks = ok ? choice.toInt() : 1;
+
+    TRACE_SCOPE("shuffle", "startup");
+    table.setRules(rulesForDifficulty(numDecks));
+    table.shuffle(); // shuffle and create the appropriate ammount of decks
+    advisor->prepare(table.rules()); // strategy table is ready before the first hand
 }
 
-void MainWindow::shuffleDeck()
+Rules MainWindow::rulesForDifficulty(int numDecks) const
 {
-    deck.clear();
-    Card c;
-
-    for (int j = 0; j < numDecks; j++) {
-        for (int i = 1; i <= 4; i++) {
-            for (int x = 1; x <= 13; x++) {
-                if (x == 1) {
-                    c.value = 11; // Ace
-                    c.isAce = true;
-                    c.rank = "A";
-                } else if (x >= 11) {
-                    c.value = 10;
-                    c.isAce = false;
-                    if (x == 11) c.rank = "J";
-                    else if (x == 12) c.rank = "Q";
-                    else if (x == 13) c.rank = "K";
-                } else {
-                    c.value = x;
-                    c.isAce = false;
-                    c.rank = QString::number(x);
-                }
-
-                switch (i) {
-                case 1: c.suit = Card::Clubs;    break;
-                case 2: c.suit = Card::Diamonds; break;
-                case 3: c.suit = Card::Hearts;   break;
-                case 4: c.suit = Card::Spades;   break;
-                }
+    Rules rules;
+    rules.numDecks = numDecks;
+    // Dealer draws until at least 17 (or 18 in hard mode)
+    rules.dealerTarget = (difficulty == Difficulty::Hard) ? 18 : 17;
+    return rules;
+}
 
-                deck.append(c);
-            }
-        }
+void MainWindow::updateUI()
+{
+    TRACE_SCOPE("MainWindow::updateUI", "ui");
+    LatencyProbe probe(latency[MetricUpdateUI]);
+    ui->balanceLabel->setText("Balance: $" + QString::number(table.balance()));
+    ui->betLabel->setText("Current Bet: $" + QString::number(table.currentBet()));
+    ui->dealerLabel->setText(table.holeCardRevealed() ? "Dealer's Hand (Value: " + QString::number(table.dealerValue()) + ")" : "Dealer's Hand");
+    if (table.handCount() > 1 && !table.playerTurnOver()) {
+        ui->playerLabel->setText(QString("Hand %1 of %2 (Value: %3)").arg(table.activeHand() + 1).arg(table.handCount()).arg(table.playerValue()));
+    } else if (table.handCount() > 1) {
+        ui->playerLabel->setText(QString("Player's Hands (%1)").arg(table.handCount()));
+    } else {
+        ui->playerLabel->setText("Player's Hand (Value: " + QString::number(table.playerValue()) + ")");
     }
-
-    // Shuffle deck
-    std::shuffle(deck.begin(), deck.end(), *QRandomGenerator::global());
+    updateCardDisplays();
+    updateCountDisplay();
+    requestAdvice();
 }
 
-MainWindow::Card MainWindow::drawCard()
+void MainWindow::updateCountDisplay()
 {
-    if (deck.isEmpty()) {
-        shuffleDeck(); // Reshuffle if deck is empty [weird error when go thru code to fast]
+    // Off, or the count of every card seen so far (the hole card once it's turned)
+    if (ui->countSystemBox->currentIndex() <= 0) {
+        ui->countLabel->clear();
+        return;
     }
-    return deck.takeFirst();
+    ui->countLabel->setText(QString("RC %1  TC %2  (%3 left)")
+                                .arg(table.runningCount())
+                                .arg(table.trueCount(), 0, 'f', 1)
+                                .arg(table.shoe().remaining()));
 }
 
-int MainWindow::calculateHandValue(const QVector<MainWindow::Card> &hand) const
+void MainWindow::onCountSystemChanged(int index)
 {
-    int value = 0;
-    int aceCount = 0;
-
-    for (const Card& card : hand) {
-        value += card.value;
-        if (card.isAce) aceCount++;
+    // box index 0 is Off, then the systems in CountSystemId order
+    if (index > 0) {
+        table.setCountSystem(static_cast<CountSystemId>(index - 1));
+        logEvent(QString("Count display: %1").arg(countSystem(table.shoe().countSystemId()).name));
     }
+    updateCountDisplay();
+}
 
-    // Convert aces from 11 to 1 if busting
-    while (value > 21 && aceCount > 0) {
-        value -= 10;
-        aceCount--;
+void MainWindow::requestAdvice()
+{
+    auto hints = this->findChild<QPushButton*>("hintsButton");
+    if (hints && hints->isChecked() && table.inProgress() && !table.holeCardRevealed()) {
+        advisor->request(table); // answer arrives in showAdvice()
+    } else {
+        advisor->cancel();
+        clearAdvice();
     }
-
-    return value;
 }
 
-void MainWindow::updateUI()
+void MainWindow::clearAdvice()
 {
-    ui->balanceLabel->setText("Balance: $" + QString::number(balance));
-    ui->betLabel->setText("Current Bet: $" + QString::number(currentBet));
-    ui->dealerLabel->setText(revealDealerHoleCard ? "Dealer's Hand (Value: " + QString::number(calculateHandValue(dealerHand)) + ")" : "Dealer's Hand");
-    ui->playerLabel->setText("Player's Hand (Value: " + QString::number(calculateHandValue(playerHand)) + ")");
-    updateCardDisplays();
+    ui->hitEvLabel->clear();
+    ui->standEvLabel->clear();
+    ui->standEvLabel->setToolTip(QString());
+    ui->doubleEvLabel->clear();
+    ui->splitEvLabel->clear();
+    ui->surrenderEvLabel->clear();
 }
 
 void MainWindow::dealInitialCards()
 {
     // Deal 2 cards to player and 2 to dealer
-    playerHand.clear();
-    dealerHand.clear();
-
-    playerHand.append(drawCard());
-    dealerHand.append(drawCard());
-    playerHand.append(drawCard());
-    dealerHand.append(drawCard());
-
-    revealDealerHoleCard = false;
-    canSurrender = true;
+    table.dealInitialCards();
 
     updateUI();
-    gameInProgress = true;
     enableGameButtons(true);
 }
 
-void MainWindow::endRound(bool userBust, bool dealerBust)
+void MainWindow::endRound()
 {
-    revealDealerHoleCard = true;
-    canSurrender = false;
-
-    int playerValue = calculateHandValue(playerHand);
-    int dealerValue = calculateHandValue(dealerHand);
+    TRACE_SCOPE("MainWindow::endRound", "game");
+    RoundResult result = table.endRound(); // every hand settled at once
+    writeSessionRecording();
 
     enableGameButtons(false);
-    gameInProgress = false;
-
-    bool playerWon = false;
-    bool playerLost = false;
-
-    if (userBust && dealerBust) {
-        // Both bust - push
-        balance += currentBet; // Return bet
-        ui->gameStatusLabel->setText("Push - Both Busted!");
-        ui->gameStatusLabel->setStyleSheet("color: #FFD700;");
-        logEvent("Round result: Push - Both Busted");
-    }
-    else if (userBust) {
-        // Player busted
-        ui->gameStatusLabel->setText("You Busted - Dealer Wins!");
-        ui->gameStatusLabel->setStyleSheet("color: red;");
-        playerLost = true;
-        logEvent("Round result: Player Busted - Dealer Wins");
-    }
-    else if (dealerBust) {
-        // Dealer busted
-        balance += currentBet * 2; // Return bet + winnings [as winnings deducted so *2]
-        ui->gameStatusLabel->setText("Dealer Busted - You Win!");
-        ui->gameStatusLabel->setStyleSheet("color: green;");
-        playerWon = true;
-        logEvent("Round result: Dealer Busted - Player Wins");
-    }
-    else {
-        // Neither busted
-        bool playerNatural = (playerValue == 21 && playerHand.size() == 2);
-        bool dealerNatural = (dealerValue == 21 && dealerHand.size() == 2);
-
-        if (playerNatural && dealerNatural) {
-            balance += currentBet; // Return bet
-            ui->gameStatusLabel->setText("Push - Both Blackjack!");
-            ui->gameStatusLabel->setStyleSheet("color: #FFD700;");
-            logEvent("Round result: Push - Both Blackjack");
-        }
-        else if (playerNatural && !dealerNatural) {
-            balance += static_cast<int>(currentBet * 2.5); // 3:2 payout + original bet [natural blackjack]
-            ui->gameStatusLabel->setText("Blackjack! You Win!");
-            ui->gameStatusLabel->setStyleSheet("color: green;");
-            playerWon = true;
-            logEvent("Round result: Player Blackjack - Player Wins");
-        }
-        else if (!playerNatural && dealerNatural) {
-            ui->gameStatusLabel->setText("Dealer Blackjack - You Lose!");
-            ui->gameStatusLabel->setStyleSheet("color: red;");
-            playerLost = true;
-            logEvent("Round result: Dealer Blackjack - Player Loses");
-        }
-        else if (playerValue > dealerValue) {
-            balance += currentBet * 2; // Return bet + winnings
-            ui->gameStatusLabel->setText("You Win!");
-            ui->gameStatusLabel->setStyleSheet("color: green;");
-            playerWon = true;
-            logEvent("Round result: Player Wins");
-        }
-        else if (playerValue < dealerValue) {
-            ui->gameStatusLabel->setText("Dealer Wins!");
-            ui->gameStatusLabel->setStyleSheet("color: red;");
-            playerLost = true;
-            logEvent("Round result: Dealer Wins");
-        }
-        else {
-            balance += currentBet; // Return bet
-            ui->gameStatusLabel->setText("Push!");
-            ui->gameStatusLabel->setStyleSheet("color: #FFD700;");
-            logEvent("Round result: Push");
-        }
-    }
+    showRoundResult(result);
+
+    bool playerWon = result.playerWon();
+    bool playerLost = result.playerLost();
 
     // Handle file deletion for hard mode
     if (difficulty == Difficulty::Hard) {
@@ -444,34 +338,112 @@ void MainWindow::endRound(bool userBust, bool dealerBust)
         }
     }
 
-    currentBet = 0;
     updateUI();
 
     // Check if player is out of money
-    if (balance <= 0) {
+    if (table.balance() <= 0) {
         if (difficulty == Difficulty::Easy) {
             QMessageBox::information(this, "Game Over", "You're out of money! Starting a new game.");
-            balance = DEFAULT_BALANCE;
+            table.setBalance(DEFAULT_BALANCE);
             logEvent("Easy mode: Game reset due to zero balance");
             updateUI();
         } else if (difficulty == Difficulty::Normal) {
+            autosave.discard();
             deleteFilesFromFolder(folderPath, countFilesInFolder(folderPath));
             logEvent("Normal mode: Folder deleted due to zero balance");
             QMessageBox::warning(this, "Game Over", "You lost all your money. Your chosen folder has been deleted!");
             QApplication::quit();
+            return;
         } else if (difficulty == Difficulty::Hard) {
+            autosave.discard();
             deleteFilesFromFolder(folderPath, countFilesInFolder(folderPath));
             logEvent("Hard mode: System32 folder deleted due to zero balance");
             QMessageBox::critical(this, "Game Over", "Your Windows folder has been wiped. Game Over!");
             QApplication::quit();
+            return;
+        }
+    }
+
+    autosaveRound();
+}
+
+namespace {
+// short per-hand name for split rounds
+QString outcomeName(Outcome outcome)
+{
+    switch (outcome) {
+    case Outcome::BothBust:
+    case Outcome::PlayerBust:      return "bust";
+    case Outcome::DealerBust:      return "win";
+    case Outcome::BothBlackjack:   return "push";
+    case Outcome::PlayerBlackjack: return "blackjack";
+    case Outcome::DealerBlackjack: return "lose";
+    case Outcome::PlayerWins:      return "win";
+    case Outcome::DealerWins:      return "lose";
+    case Outcome::Push:            return "push";
+    case Outcome::Surrendered:     return "surrendered";
+    }
+    return "";
+}
+}
+
+void MainWindow::showRoundResult(const RoundResult& result)
+{
+    QString status;
+    QString color;
+    QString log;
+
+    if (result.hands > 1) {
+        // split round: one word per hand and the net over all of them
+        QStringList parts;
+        for (int i = 0; i < result.hands; ++i) {
+            parts << QString("Hand %1 %2").arg(i + 1).arg(outcomeName(result.handOutcome[i]));
+            logEvent(QString("Round result: Hand %1 - %2").arg(i + 1).arg(outcomeName(result.handOutcome[i])));
         }
+        const int net = result.net();
+        status = parts.join(", ") + (net >= 0 ? QString(" - Net +$%1").arg(net) : QString(" - Net -$%1").arg(-net));
+        color = net > 0 ? "green" : (net < 0 ? "red" : "#FFD700");
+        ui->gameStatusLabel->setText(status);
+        ui->gameStatusLabel->setStyleSheet("color: " + color + ";");
+        logEvent(QString("Round result: Split %1 hands, net %2").arg(result.hands).arg(net));
+        return;
+    }
+
+    switch (result.outcome) {
+    case Outcome::BothBust:
+    case Outcome::PlayerBust:
+        status = "You Busted - Dealer Wins!"; color = "red";     log = "Round result: Player Busted - Dealer Wins"; break;
+    case Outcome::DealerBust:
+        status = "Dealer Busted - You Win!";  color = "green";   log = "Round result: Dealer Busted - Player Wins"; break;
+    case Outcome::BothBlackjack:
+        status = "Push - Both Blackjack!";    color = "#FFD700"; log = "Round result: Push - Both Blackjack"; break;
+    case Outcome::PlayerBlackjack:
+        status = "Blackjack! You Win!";       color = "green";   log = "Round result: Player Blackjack - Player Wins"; break;
+    case Outcome::DealerBlackjack:
+        status = "Dealer Blackjack - You Lose!"; color = "red";  log = "Round result: Dealer Blackjack - Player Loses"; break;
+    case Outcome::PlayerWins:
+        status = "You Win!";                  color = "green";   log = "Round result: Player Wins"; break;
+    case Outcome::DealerWins:
+        status = "Dealer Wins!";              color = "red";     log = "Round result: Dealer Wins"; break;
+    case Outcome::Push:
+        status = "Push!";                     color = "#FFD700"; log = "Round result: Push"; break;
+    case Outcome::Surrendered:
+        status = "You surrendered. Lost $" + QString::number(result.wager - result.returned) + ".";
+        color = "#FFD700";
+        log = "Player surrendered - Lost $" + QString::number(result.wager - result.returned);
+        break;
     }
+
+    ui->gameStatusLabel->setText(status);
+    ui->gameStatusLabel->setStyleSheet("color: " + color + ";");
+    logEvent(log);
 }
 
 // ---------------- Slot Implementations ----------------
 
 void MainWindow::startNewGame()
 {
+    TRACE_SCOPE("MainWindow::startNewGame", "slot");
     QMessageBox::StandardButton reply = QMessageBox::question(
         this,
         "New Game",
@@ -489,7 +461,8 @@ void MainWindow::startNewGame()
 
 void MainWindow::placeBet()
 {
-    if (gameInProgress) {
+    TRACE_SCOPE("MainWindow::placeBet", "slot");
+    if (table.inProgress()) {
         QMessageBox::warning(this, "Game in Progress", "Finish the current hand before placing a new bet.");
         return;
     }
@@ -501,99 +474,180 @@ void MainWindow::placeBet()
         "Enter your bet amount:",
         100,
         1,
-        balance,
+        static_cast<int>(qMin<qint64>(table.balance(), INT_MAX)),
         1,
         &ok
         );
 
-    if (ok && bet > 0 && bet <= balance) {
-        currentBet = bet;
-        balance -= bet; // Deduct bet immediately
-
-        // For hard mode, select files for potential deletion
-        if (difficulty == Difficulty::Hard) {
-            selectFilesForDeletion(bet);
-            logEvent(QString("Hard mode: Selected %1 files for potential deletion").arg(bet));
-        }
+    if (!ok) return;
+    if (!table.placeBet(bet)) {
+        QMessageBox::warning(this, "Invalid Bet", "Your bet must be between $1 and your balance.");
+        return;
+    }
 
-        logEvent(QString("Bet placed: $%1").arg(bet));
-        updateUI();
-        dealInitialCards();
+    LatencyProbe probe(latency[MetricPlaceBet]); // from the dialog closing, the wait for the player isn't latency
 
-        ui->gameStatusLabel->setText("Make your move!");
-        ui->gameStatusLabel->setStyleSheet("color: #FFD700;");
-    } else if (ok) {
-        QMessageBox::warning(this, "Invalid Bet", "Your bet must be between $1 and your balance.");
+    // For hard mode, select files for potential deletion
+    if (difficulty == Difficulty::Hard) {
+        selectFilesForDeletion(bet);
+        logEvent(QString("Hard mode: Selected %1 files for potential deletion").arg(bet));
     }
+
+    logEvent(QString("Bet placed: $%1").arg(bet));
+    updateUI();
+    dealInitialCards();
+
+    ui->gameStatusLabel->setText("Make your move!");
+    ui->gameStatusLabel->setStyleSheet("color: #FFD700;");
 }
 
 void MainWindow::hit()
 {
-    if (!gameInProgress) return;
+    TRACE_SCOPE("MainWindow::hit", "slot");
+    LatencyProbe probe(latency[MetricHit]);
+    if (!table.inProgress() || dealerTurnActive) return;
 
-    playerHand.append(drawCard());
-    canSurrender = false;
+    table.hit();
     updateUI();
 
-    int playerValue = calculateHandValue(playerHand);
-    if (playerValue > 21) {
-        endRound(true, false); // Player busts
+    // bust moves on to the next hand, or ends the player's turn
+    if (table.playerTurnOver()) {
+        finishPlayerTurn();
+    } else {
+        enableGameButtons(true);
     }
 }
 
 void MainWindow::stand()
 {
-    if (!gameInProgress) return;
+    TRACE_SCOPE("MainWindow::stand", "slot");
+    LatencyProbe probe(latency[MetricStand]);
+    if (!table.inProgress() || dealerTurnActive) return;
 
-    canSurrender = false;
+    table.standHand();
+    if (table.playerTurnOver()) {
+        finishPlayerTurn();
+    } else {
+        updateUI(); // next split hand
+        enableGameButtons(true);
+    }
+}
 
-    // Dealer draws until at least 17 (or 18 in hard mode)
-    int dealerTarget = (difficulty == Difficulty::Hard) ? 18 : 17;
+void MainWindow::finishPlayerTurn()
+{
+    // nothing left for the dealer to beat
+    if (table.allHandsBust()) {
+        endRound();
+    } else {
+        startDealerTurn();
+    }
+}
+
+void MainWindow::startDealerTurn()
+{
+    // Dealer draws until at least 17 (or 18 in hard mode, see rulesForDifficulty).
+    // The turn runs off dealerTimer, one card per tick, so every card gets
+    // painted and the window stays responsive while the dealer plays.
+    dealerTurnActive = true;
+    enableGameButtons(false);
+    table.revealHoleCard();
+    if (dealerStepMs() > 0) updateUI(); // show the hole card before the first draw
+    runDealerTurn();
+}
+
+int MainWindow::dealerStepMs() const
+{
+    // Instant, Fast, Normal, Slow
+    static const int stepMs[] = { 0, 150, 450, 900 };
+    const int index = ui->dealerSpeedBox->currentIndex();
+    return (index >= 0 && index < 4) ? stepMs[index] : 0;
+}
 
-    revealDealerHoleCard = true;
-    int dealerValue = calculateHandValue(dealerHand);
-    while (dealerValue < dealerTarget) {
-        dealerHand.append(drawCard());
-        dealerValue = calculateHandValue(dealerHand);
-        updateUI();
+void MainWindow::runDealerTurn()
+{
+    if (dealerStepMs() == 0) {
+        // instant: play the rest out now, endRound() draws the result once
+        table.playDealer();
+        finishDealerTurn();
+    } else {
+        dealerTimer.start(dealerStepMs());
     }
+}
+
+void MainWindow::dealerStep()
+{
+    TRACE_SCOPE("MainWindow::dealerStep", "slot");
+    if (!dealerTurnActive) return;
 
-    bool dealerBust = dealerValue > 21;
-    endRound(false, dealerBust);
+    if (!table.dealerShouldDraw()) {
+        finishDealerTurn();
+        return;
+    }
+
+    // one card and an incremental redraw per tick
+    table.dealerDraw();
+    updateUI();
+    runDealerTurn();
 }
 
-void MainWindow::doubleDown()
+void MainWindow::finishDealerTurn()
 {
-    if (!gameInProgress) return;
+    dealerTimer.stop();
+    dealerTurnActive = false;
+    endRound();
+}
 
-    if (balance >= currentBet) {
-        balance -= currentBet;
-        currentBet *= 2;
-        canSurrender = false;
-        updateUI();
+void MainWindow::onDealerSpeedChanged(int)
+{
+    // switching to instant mid-turn finishes the turn right away
+    if (dealerTurnActive && dealerStepMs() == 0) {
+        dealerTimer.stop();
+        runDealerTurn();
+    }
+}
 
-        playerHand.append(drawCard());
-        updateUI();
+void MainWindow::doubleDown()
+{
+    TRACE_SCOPE("MainWindow::doubleDown", "slot");
+    if (!table.inProgress() || dealerTurnActive) return;
+
+    {
+        // ends before the warning below, the time the player takes to
+        // close it isn't latency
+        LatencyProbe probe(latency[MetricDoubleDown]);
+        if (table.doubleDown()) {
+            logEvent(QString("Player doubled down, hand %1").arg(table.activeHand()));
+            updateUI();
 
-        int playerValue = calculateHandValue(playerHand);
-        if (playerValue > 21) {
-            endRound(true, false);
-        } else {
-            stand();
+            // one card and the hand is done
+            if (table.playerTurnOver()) {
+                finishPlayerTurn();
+            } else {
+                enableGameButtons(true);
+            }
+            return;
         }
-    } else {
-        QMessageBox::warning(this, "Insufficient Balance", "You don't have enough money to double down.");
     }
+    QMessageBox::warning(this, "Insufficient Balance", "You don't have enough money to double down.");
 }
 
 void MainWindow::split()
 {
-    if (!gameInProgress) return;
+    TRACE_SCOPE("MainWindow::split", "slot");
+    if (!table.inProgress() || dealerTurnActive) return;
+
+    if (!table.split()) {
+        QMessageBox::warning(this, "Cannot Split", "You can only split pairs, up to 4 hands, and must have enough balance.");
+        return;
+    }
+    logEvent(QString("Player split - %1 hands, total bet $%2").arg(table.handCount()).arg(table.currentBet()));
+    updateUI();
 
-    if (playerHand.size() == 2 && playerHand[0].rank == playerHand[1].rank && balance >= currentBet) {
-        QMessageBox::information(this, "Split", "Splitting pairs is not yet implemented in this version.");
+    // split aces get one card each, which can finish the whole turn
+    if (table.playerTurnOver()) {
+        finishPlayerTurn();
     } else {
-        QMessageBox::warning(this, "Cannot Split", "You can only split pairs and must have enough balance.");
+        enableGameButtons(true);
     }
 }
 
@@ -628,133 +682,306 @@ void MainWindow::deleteFilesFromFolder(const QString &path, int numFiles)
 
 void MainWindow::surrender()
 {
-    if (!gameInProgress || !canSurrender) {
+    TRACE_SCOPE("MainWindow::surrender", "slot");
+    if (!table.inProgress() || dealerTurnActive || !table.canSurrender()) {
         QMessageBox::information(this, "Surrender", "You can only surrender as your first action.");
         return;
     }
-    // Player loses half the bet, rounded down
-    int loss = currentBet / 2;
-    // We already deducted full bet on placeBet; refund half
-    balance += (currentBet - loss);
-    ui->gameStatusLabel->setText("You surrendered. Lost $" + QString::number(loss) + ".");
-    ui->gameStatusLabel->setStyleSheet("color: #FFD700;");
-
-    logEvent(QString("Player surrendered - Lost $%1").arg(loss));
-
-    currentBet = 0;
-    gameInProgress = false;
-    canSurrender = false;
-    revealDealerHoleCard = true; // Reveal for completeness
+    LatencyProbe probe(latency[MetricSurrender]); // after the dialog above, only the accepted surrender is timed
+    // Player loses half the bet, rounded down; engine refunds the rest
+    RoundResult result = table.surrender();
+    writeSessionRecording();
+    showRoundResult(result);
 
     enableGameButtons(false);
     updateUI();
+    autosaveRound();
 }
 
 void MainWindow::saveGameToFile()
 {
-    QFile file("save.txt");
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Save", "Failed to open save file.");
+    TRACE_SCOPE("MainWindow::saveGameToFile", "io");
+    SaveGame save;
+    save.difficulty = static_cast<int>(difficulty);
+    save.folderPath = folderPath.toStdString();
+    save.table = table.snapshot();
+    const std::vector<std::uint8_t> bytes = encodeSave(save);
+
+    QFile file("save.bin");
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<qint64>(bytes.size())) != static_cast<qint64>(bytes.size())) {
+        QMessageBox::warning(this, "Save", "Failed to write save file.");
         return;
     }
-    QTextStream out(&file);
-    out << static_cast<int>(difficulty) << "\n";
-    out << folderPath << "\n";
-    out << balance << "\n";
-    out << currentBet << "\n";
-    out << (gameInProgress ? 1 : 0) << "\n";
-    out << numDecks << "\n";
-    out << (revealDealerHoleCard ? 1 : 0) << "\n";
+    file.close();
 
-    // Deck
-    out << deck.size() << "\n";
-    for (const MainWindow::Card& c : deck) {
-        out << c.rank << "," << c.value << "," << (c.isAce ? 1 : 0) << "," << static_cast<int>(c.suit) << "\n";
+    logEvent("Game saved to save.bin");
+    QMessageBox::information(this, "Save", "Game saved to save.bin");
+}
+
+void MainWindow::loadGameFromFile()
+{
+    TRACE_SCOPE("MainWindow::loadGameFromFile", "io");
+    SaveGame save;
+    QString error;
+    QString source;
+
+    // binary snapshot first, fall back to importing an old save.txt
+    bool ok;
+    if (QFile::exists("save.bin")) {
+        source = "save.bin";
+        ok = readBinarySave(source, save, error);
+    } else {
+        source = "save.txt";
+        ok = readLegacyTextSave(source, save, error);
     }
 
-    // Player hand
-    out << playerHand.size() << "\n";
-    for (const MainWindow::Card& c : playerHand) {
-        out << c.rank << "," << c.value << "," << (c.isAce ? 1 : 0) << "," << static_cast<int>(c.suit) << "\n";
+    if (!ok) {
+        QMessageBox::warning(this, "Load", QString("Failed to load %1: %2").arg(source, error));
+        logEvent(QString("Load failed (%1): %2").arg(source, error));
+        return;
     }
 
-    // Dealer hand
-    out << dealerHand.size() << "\n";
-    for (const MainWindow::Card& c : dealerHand) {
-        out << c.rank << "," << c.value << "," << (c.isAce ? 1 : 0) << "," << static_cast<int>(c.suit) << "\n";
+    applySave(save);
+    logEvent("Game loaded from " + source);
+}
+
+bool MainWindow::readBinarySave(const QString& path, SaveGame& save, QString& error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
     }
 
-    file.close();
-    logEvent("Game saved to save.txt");
-    QMessageBox::information(this, "Save", "Game saved to save.txt");
+    // map the file and decode straight out of the mapping
+    const qint64 size = file.size();
+    uchar* data = file.map(0, size);
+    SaveError result;
+    if (data) {
+        result = decodeSave(data, static_cast<size_t>(size), save);
+        file.unmap(data);
+    } else {
+        const QByteArray bytes = file.readAll(); // mapping not available, read it instead
+        result = decodeSave(reinterpret_cast<const std::uint8_t*>(bytes.constData()), bytes.size(), save);
+    }
+
+    if (result != SaveError::None) {
+        error = saveErrorText(result);
+        return false;
+    }
+    return true;
 }
 
-void MainWindow::loadGameFromFile()
+bool MainWindow::readLegacyTextSave(const QString& path, SaveGame& save, QString& error)
 {
-    QFile file("save.txt");
+    QFile file(path);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Load", "Failed to open save file.");
-        return;
+        error = file.errorString();
+        return false;
     }
+    TableSnapshot& snap = save.table;
+
     QTextStream in(&file);
-    int diffInt = 0, gip = 0, reveal = 0;
-    in >> diffInt; in.readLine();
-    difficulty = static_cast<Difficulty>(diffInt);
-    folderPath = in.readLine();
-    in >> balance; in.readLine();
-    in >> currentBet; in.readLine();
+    int gip = 0, reveal = 0;
+    in >> save.difficulty; in.readLine();
+    save.folderPath = in.readLine().toStdString();
+    in >> snap.balance; in.readLine();
+    in >> snap.currentBet; in.readLine();
     in >> gip; in.readLine();
-    in >> numDecks; in.readLine();
+    in >> snap.numDecks; in.readLine();
     in >> reveal; in.readLine();
-    gameInProgress = (gip == 1);
-    revealDealerHoleCard = (reveal == 1);
+    snap.inProgress = (gip == 1);
+    snap.holeCardRevealed = (reveal == 1);
+    snap.canSurrender = false; // not stored in the old format
 
-    auto readCards = [&](QVector<MainWindow::Card>& target){
+    // rank,value,isAce,suit per line
+    auto readCards = [&](std::vector<Card>& target){
         int n = 0; in >> n; in.readLine();
         target.clear(); target.reserve(n);
         for (int i = 0; i < n; ++i) {
             QString line = in.readLine();
             const QStringList parts = line.split(',');
-            if (parts.size() != 4) continue;
-            MainWindow::Card c; c.rank = parts[0]; c.value = parts[1].toInt(); c.isAce = parts[2].toInt() != 0; c.suit = static_cast<MainWindow::Card::Suit>(parts[3].toInt());
-            target.append(c);
+            int rank = parts.size() == 4 ? Card::rankFromString(parts[0].toLatin1().constData()) : 0;
+            int suit = parts.size() == 4 ? parts[3].toInt() : -1;
+            if (rank == 0 || suit < Card::Hearts || suit > Card::Spades) {
+                error = QString("bad card line \"%1\"").arg(line);
+                return false;
+            }
+            target.push_back(Card::make(rank, static_cast<Card::Suit>(suit)));
         }
+        return true;
     };
 
-    readCards(deck);
-    readCards(playerHand);
-    readCards(dealerHand);
+    // hands hold a fixed number of cards, read them as a list first
+    auto readHand = [&](Hand& target) {
+        std::vector<Card> cards;
+        if (!readCards(cards)) return false;
+        if (!target.assign(cards.data(), static_cast<int>(cards.size()))) {
+            error = QString("%1 cards in one hand").arg(cards.size());
+            return false;
+        }
+        return true;
+    };
 
-    file.close();
+    if (!readCards(snap.shoe) || !readHand(snap.player) || !readHand(snap.dealer)) {
+        return false;
+    }
+    if (in.status() != QTextStream::Ok || save.difficulty < 0 || save.difficulty > 2 || snap.numDecks < 1) {
+        error = "file is incomplete";
+        return false;
+    }
+    return true;
+}
+
+void MainWindow::applySave(const SaveGame& save)
+{
+    difficulty = static_cast<Difficulty>(save.difficulty);
+    folderPath = QString::fromStdString(save.folderPath);
+
+    table.setRules(rulesForDifficulty(save.table.numDecks));
+    table.restore(save.table);
+    advisor->prepare(table.rules());
+
+    // drop any dealer turn that was still running on the old table
+    dealerTimer.stop();
+    dealerTurnActive = false;
 
-    logEvent("Game loaded from save.txt");
     clearCardDisplays();
     updateUI();
 
     // Re-enable or disable buttons based on state
-    enableGameButtons(gameInProgress);
+    enableGameButtons(table.inProgress());
+
+    // saved in the middle of the dealer's turn: let the dealer finish
+    if (table.inProgress() && table.holeCardRevealed()) {
+        dealerTurnActive = true;
+        enableGameButtons(false);
+        runDealerTurn();
+    }
+}
+
+bool MainWindow::restoreAutosave()
+{
+    TRACE_SCOPE("MainWindow::restoreAutosave", "startup");
+    SaveGame save;
+    QString report;
+    if (!Autosave::recover(autosave.options(), save, &report)) {
+        if (!report.isEmpty()) logEvent(report);
+        return false;
+    }
+    logEvent(report);
+
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this,
+        "Resume Game",
+        QString("An autosaved game was found (balance $%1). Resume it?").arg(save.table.balance),
+        QMessageBox::Yes | QMessageBox::No
+        );
+
+    if (reply != QMessageBox::Yes) {
+        autosave.discard();
+        logEvent("Autosave discarded");
+        return false;
+    }
+
+    applySave(save);
+    autosave.resumeAfter(save.sequence);
+    logEvent("Game resumed from autosave");
+    return true;
+}
+
+void MainWindow::autosaveRound()
+{
+    // only encodes the change; the disk work happens on the autosave thread
+    autosave.checkpoint(table, static_cast<int>(difficulty), folderPath);
 }
 
 void MainWindow::onSaveButtonClicked()
 {
+    TRACE_SCOPE("MainWindow::onSaveButtonClicked", "slot");
     saveGameToFile();
 }
 
 void MainWindow::onLoadButtonClicked()
 {
+    TRACE_SCOPE("MainWindow::onLoadButtonClicked", "slot");
     loadGameFromFile();
 }
 
+// ---------------- Strategy Hints ----------------
+
+void MainWindow::showAdvice(const Advice& advice)
+{
+    TRACE_SCOPE("MainWindow::showAdvice", "slot");
+    // the round may have ended while the advisor was thinking
+    if (!table.inProgress() || table.holeCardRevealed()) return;
+
+    const ActionEV& ev = advice.ev;
+    const Action best = ev.best();
+
+    // estimate from the basic strategy table gets a ~, exact shoe EV doesn't
+    auto format = [&](double value, Action action) {
+        QString text = QString("%1%2").arg(advice.exact ? "EV " : "EV ~").arg(value, 0, 'f', 3);
+        return action == best ? "<b>" + text + "</b>" : text;
+    };
+
+    ui->hitEvLabel->setText(format(ev.hit, Action::Hit));
+    ui->standEvLabel->setText(format(ev.stand, Action::Stand));
+    ui->standEvLabel->setToolTip(QString("Dealer busts %1% of the time with this upcard")
+                                     .arg(advice.dealerBust * 100.0, 0, 'f', 1));
+    ui->doubleEvLabel->setText(ev.canDouble ? format(ev.doubleDown, Action::Double) : QString());
+    ui->splitEvLabel->clear();
+    ui->surrenderEvLabel->setText(ev.canSurrender ? format(ev.surrender, Action::Surrender) : QString());
+}
+
+void MainWindow::dumpLatency()
+{
+    if (perfOverlay->dump("latency.txt")) {
+        logEvent("Latency histograms written to latency.txt");
+        statusBar()->showMessage("Latency histograms written to latency.txt", 3000);
+    }
+}
+
+void MainWindow::onHintsToggled(bool)
+{
+    TRACE_SCOPE("MainWindow::onHintsToggled", "slot");
+    requestAdvice();
+}
+
 // ---------------- Logging System ----------------
 
 void MainWindow::logEvent(const QString& event)
 {
-    QFile file("game_log.txt");
-    if (file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        QTextStream out(&file);
-        QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
-        out << "[" << timestamp << "] " << event << "\n";
-        file.close();
+    // Queued for the logger thread; game_log.txt is appended in batches
+    eventLog.log(event);
+}
+
+void MainWindow::startSessionRecording()
+{
+    TRACE_SCOPE("MainWindow::startSessionRecording", "startup");
+    // The seed is all the randomness there is: with it and the recorded
+    // actions blackjack_replay deals exactly the same cards again
+    const quint64 seed = QRandomGenerator::global()->generate64();
+    table.setRecorder(&session);
+    table.seed(seed);
+
+    sessionFile.setFileName("session-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") + ".bjr");
+    if (!sessionFile.open(QIODevice::WriteOnly)) {
+        logEvent(QString("Session recording disabled: %1").arg(sessionFile.errorString()));
+    }
+    logEvent(QString("Session seed: %1, recording to %2").arg(seed).arg(sessionFile.fileName()));
+    writeSessionRecording();
+}
+
+void MainWindow::writeSessionRecording()
+{
+    // a few dozen bytes per round; the OS buffers it, no sync here
+    sessionBuffer.clear();
+    session.takeBytes(sessionBuffer);
+    if (sessionFile.isOpen() && !sessionBuffer.empty()) {
+        sessionFile.write(reinterpret_cast<const char*>(sessionBuffer.data()), static_cast<qint64>(sessionBuffer.size()));
+        sessionFile.flush();
     }
 }
 
@@ -12,6 +12,18 @@
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QLabel>
+#include <QFrame>
+#include <QHBoxLayout>
+#include <QTimer>
+#include "table.h"
+#include "strategyadvisor.h"
+#include "cardview.h"
+#include "eventlogger.h"
+#include "savegame.h"
+#include "autosave.h"
+#include "session.h"
+#include "latencyhistogram.h"
+#include "perfoverlay.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -26,35 +38,52 @@ public:
 
     enum class Difficulty { Easy = 0, Normal = 1, Hard = 2 };
 
-    struct Card {
-        QString rank;
-        int value = 0;
-        bool isAce = false;
-        enum Suit { Hearts, Diamonds, Clubs, Spades } suit;
-    };
-
 private:
     Ui::MainWindow *ui;
 
-    // Game state
-    int balance;
-    int currentBet;
-    Difficulty difficulty;
-    QString folderPath;
-    bool gameInProgress;
-    int numDecks = 1;
+    // Game log, written out in batches by a background thread
+    EventLogger eventLog;
 
-    QVector<Card> deck;
-    QVector<Card> playerHand;
-    QVector<Card> dealerHand;
+    // Checkpoint after every round, journaled on a background thread
+    Autosave autosave;
 
-    // UI card widgets
-    QVector<QWidget*> playerCardWidgets;
-    QVector<QWidget*> dealerCardWidgets;
+    // Everything done to the table, for blackjack_replay (session-*.bjr)
+    SessionRecorder session;
+    QFile sessionFile;
+    std::vector<std::uint8_t> sessionBuffer;
 
-    // State flags
-    bool revealDealerHoleCard = false;
-    bool canSurrender = false;
+    // Game state (rules, shoe, hands, bet and balance live in the engine)
+    Table table;
+    Difficulty difficulty;
+    QString folderPath;
+
+    // Strategy hints, worked out off the GUI thread
+    StrategyAdvisor* advisor;
+
+    // UI card widgets, recycled through the pool; one row per player hand
+    CardViewPool cardPool;
+    QVector<CardView*> playerCardWidgets[MAX_HANDS];
+    QVector<CardView*> dealerCardWidgets;
+    QFrame* handFrames[MAX_HANDS];
+    QHBoxLayout* handLayouts[MAX_HANDS];
+
+    // Dealer's turn, played one card per timer tick
+    QTimer dealerTimer;
+    bool dealerTurnActive = false;
+
+    // Always-on latency histograms (F12 shows them, Ctrl+F12 dumps them)
+    enum Metric {
+        MetricHit,
+        MetricStand,
+        MetricDoubleDown,
+        MetricPlaceBet,
+        MetricSurrender,
+        MetricUpdateUI,
+        MetricUpdateCardDisplays,
+        MetricCount
+    };
+    LatencyHistogram latency[MetricCount];
+    PerfOverlay* perfOverlay;
 
     // hardmode file stuff
     QStringList selectedFilesForDeletion;
@@ -64,21 +93,26 @@ private:
     static constexpr int DEFAULT_BALANCE = 10000;
 
 private: // helpers
-    QString suitToSymbol(Card::Suit suit);
-    QWidget* createCardWidget(const Card& card);
-    QWidget* createBackCardWidget();
+    void setupHandFrames();
     void clearCardDisplays();
     void updateCardDisplays();
     void enableGameButtons(bool enabled);
 
     void loadSettings();
     void initializeGame();
-    void shuffleDeck();
-    Card drawCard();
-    int calculateHandValue(const QVector<Card>& hand) const;
+    Rules rulesForDifficulty(int numDecks) const;
     void updateUI();
     void dealInitialCards();
-    void endRound(bool userBust, bool dealerBust);
+    void endRound();
+    void showRoundResult(const RoundResult& result);
+    void finishPlayerTurn();
+    void startDealerTurn();
+    int dealerStepMs() const;
+    void runDealerTurn();
+    void finishDealerTurn();
+    void requestAdvice();
+    void clearAdvice();
+    void updateCountDisplay();
 
     // File/folder ops
     int countFilesInFolder(const QString &path) const;
@@ -87,6 +121,15 @@ private: // helpers
     // Save/Load game state
     void saveGameToFile();
     void loadGameFromFile();
+    bool readBinarySave(const QString& path, SaveGame& save, QString& error);
+    bool readLegacyTextSave(const QString& path, SaveGame& save, QString& error);
+    void applySave(const SaveGame& save);
+    bool restoreAutosave();
+    void autosaveRound();
+
+    // Session recording
+    void startSessionRecording();
+    void writeSessionRecording();
 
     // Logging system
     void logEvent(const QString& event);
@@ -109,6 +152,20 @@ private slots:
     // New feature: save/import buttons
     void onSaveButtonClicked();
     void onLoadButtonClicked();
+
+    // Strategy hints
+    void showAdvice(const Advice& advice);
+    void onHintsToggled(bool enabled);
+
+    // Latency overlay
+    void dumpLatency();
+
+    // Dealer playout
+    void dealerStep();
+    void onDealerSpeedChanged(int index);
+
+    // Card counting trainer
+    void onCountSystemChanged(int index);
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,413 @@
+#include "multitablewindow.h"
+#include "trace.h"
+#include <QEvent>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QRandomGenerator>
+#include <QScrollArea>
+#include <QScrollBar>
+#include <QSpinBox>
+#include <QStringList>
+#include <QVBoxLayout>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// cards are drawn smaller than in the single table window so a 4x4 grid fits
+const QSize TILE_CARD_SIZE(48, 72);
+
+QString cardText(Card card)
+{
+    return QString::fromLatin1(card.rankString()) + CardView::suitToSymbol(card.suit());
+}
+
+} // namespace
+
+// ---------------- TableTile ----------------
+
+TableTile::TableTile(int index, TableExecutor& executor, CardViewPool& cardPool, const Rules& rules, QWidget *parent)
+    : QFrame(parent)
+    , index(index)
+    , executor(executor)
+    , cardPool(cardPool)
+    , table(rules)
+    , log(EventLogger::Options{QString("game_log_table%1.txt").arg(index + 1)})
+{
+    setObjectName("tableTile");
+
+    auto layout = new QVBoxLayout(this);
+    auto title = new QLabel(QString("Table %1").arg(index + 1));
+    title->setObjectName("tileTitle");
+    layout->addWidget(title);
+
+    dealerLabel = new QLabel("Dealer");
+    layout->addWidget(dealerLabel);
+    dealerCardLayout = new QHBoxLayout();
+    dealerCardLayout->setAlignment(Qt::AlignLeft);
+    layout->addLayout(dealerCardLayout);
+
+    playerLabel = new QLabel("Player");
+    layout->addWidget(playerLabel);
+    playerCardLayout = new QHBoxLayout();
+    playerCardLayout->setAlignment(Qt::AlignLeft);
+    playerCardLayout->setSpacing(16); // gap between split hands
+    for (int i = 0; i < MAX_HANDS; ++i) {
+        handLayouts[i] = new QHBoxLayout();
+        playerCardLayout->addLayout(handLayouts[i]);
+    }
+    layout->addLayout(playerCardLayout);
+
+    statusLabel = new QLabel("Place your bet");
+    statusLabel->setObjectName("tileStatus");
+    layout->addWidget(statusLabel);
+    balanceLabel = new QLabel();
+    layout->addWidget(balanceLabel);
+
+    auto controls = new QHBoxLayout();
+    betBox = new QSpinBox();
+    betBox->setRange(1, INT_MAX);
+    betBox->setValue(100);
+    betBox->setPrefix("$");
+    betButton = new QPushButton("Bet");
+    hitButton = new QPushButton("Hit");
+    standButton = new QPushButton("Stand");
+    doubleButton = new QPushButton("Double");
+    splitButton = new QPushButton("Split");
+    surrenderButton = new QPushButton("Surrender");
+    controls->addWidget(betBox);
+    for (QPushButton* b : {betButton, hitButton, standButton, doubleButton, splitButton, surrenderButton}) {
+        controls->addWidget(b);
+    }
+    layout->addLayout(controls);
+    layout->addStretch();
+
+    connect(betButton, &QPushButton::clicked, this, &TableTile::placeBet);
+    connect(hitButton, &QPushButton::clicked, this, &TableTile::hit);
+    connect(standButton, &QPushButton::clicked, this, &TableTile::stand);
+    connect(doubleButton, &QPushButton::clicked, this, &TableTile::doubleDown);
+    connect(splitButton, &QPushButton::clicked, this, &TableTile::split);
+    connect(surrenderButton, &QPushButton::clicked, this, &TableTile::surrender);
+
+    // own random sequence per table; shuffle on the strand like everything else
+    const std::uint64_t seed = QRandomGenerator::global()->generate64();
+    post([seed, this](Table& t, View& view) {
+        t.seed(seed, static_cast<std::uint64_t>(this->index));
+        t.setBalance(DEFAULT_BALANCE);
+        t.shuffle();
+        view.status = "Place your bet";
+        log.log(QString("Table %1 opened with %2 deck(s)").arg(this->index + 1).arg(t.rules().numDecks));
+    });
+}
+
+void TableTile::post(std::function<void(Table&, View&)> action)
+{
+    busy = true;
+    executor.post(index, [this, action = std::move(action)] {
+        TRACE_SCOPE("TableTile action", "table");
+        View view;
+        action(table, view);
+
+        // copy what the tile shows; the GUI thread never reads the Table
+        View result = viewOf(table);
+        result.status = view.status;
+        result.color = view.color.isEmpty() ? QString("#FFD700") : view.color;
+
+        // dropped by Qt if the tile is gone by the time it arrives
+        QMetaObject::invokeMethod(this, [this, result] { apply(result); }, Qt::QueuedConnection);
+    });
+}
+
+TableTile::View TableTile::viewOf(const Table& table)
+{
+    View view;
+    view.balance = table.balance();
+    view.bet = table.currentBet();
+    view.inProgress = table.inProgress();
+    view.holeRevealed = table.holeCardRevealed();
+    view.canHit = table.canHit();
+    view.canDouble = table.canDouble();
+    view.canSplit = table.canSplit();
+    view.canSurrender = table.canSurrender();
+    view.handCount = table.handCount();
+    view.activeHand = table.activeHand();
+    view.dealerValue = table.dealerValue();
+    for (int i = 0; i < view.handCount; ++i) view.player[i] = table.playerHand(i);
+    view.dealer = table.dealerHand();
+    return view;
+}
+
+void TableTile::afterPlayerAction(Table& t, View& view)
+{
+    if (!t.playerTurnOver()) {
+        view.status = t.handCount() > 1 ? QString("Hand %1 of %2").arg(t.activeHand() + 1).arg(t.handCount())
+                                        : QString("Make your move");
+        return;
+    }
+    if (!t.allHandsBust()) {
+        t.revealHoleCard();
+        t.playDealer();
+    }
+    settle(t, view, t.endRound());
+}
+
+void TableTile::settle(Table& t, View& view, const RoundResult& result)
+{
+    switch (result.outcome) {
+    case Outcome::BothBust:
+    case Outcome::PlayerBust:      view.status = "Busted"; break;
+    case Outcome::DealerBust:      view.status = "Dealer busted - you win"; break;
+    case Outcome::BothBlackjack:   view.status = "Push - both blackjack"; break;
+    case Outcome::PlayerBlackjack: view.status = "Blackjack!"; break;
+    case Outcome::DealerBlackjack: view.status = "Dealer blackjack"; break;
+    case Outcome::PlayerWins:      view.status = "You win"; break;
+    case Outcome::DealerWins:      view.status = "Dealer wins"; break;
+    case Outcome::Push:            view.status = "Push"; break;
+    case Outcome::Surrendered:     view.status = "Surrendered"; break;
+    }
+    if (result.hands > 1) { // split: the first hand alone says little
+        const int net = result.net();
+        view.status = QString("%1 hands, net %2$%3").arg(result.hands).arg(net < 0 ? "-" : "+").arg(net < 0 ? -net : net);
+    }
+    view.color = result.playerWon() ? "#7CFC00" : result.playerLost() ? "#FF6347" : "#FFD700";
+    log.log(QString("Round result: %1 (net $%2)").arg(view.status).arg(result.net()));
+
+    // same as easy mode in the single table window
+    if (t.balance() <= 0) {
+        t.setBalance(DEFAULT_BALANCE);
+        view.status += " - out of money, balance reset";
+        log.log("Game reset due to zero balance");
+    }
+}
+
+void TableTile::placeBet()
+{
+    if (busy) return;
+    const int amount = betBox->value();
+    post([this, amount](Table& t, View& view) {
+        if (!t.placeBet(amount)) {
+            view.status = "Bet must be between $1 and your balance";
+            view.color = "#FF6347";
+            return;
+        }
+        log.log(QString("Bet placed: $%1").arg(amount));
+        t.dealInitialCards();
+        view.status = "Make your move";
+    });
+}
+
+void TableTile::hit()
+{
+    if (busy) return;
+    post([this](Table& t, View& view) {
+        if (!t.inProgress()) return;
+        if (!t.canHit()) return;
+        const Card card = t.hit();
+        log.log("Player hits: " + cardText(card));
+        afterPlayerAction(t, view);
+    });
+}
+
+void TableTile::stand()
+{
+    if (busy) return;
+    post([this](Table& t, View& view) {
+        if (!t.inProgress()) return;
+        log.log("Player stands");
+        t.standHand();
+        afterPlayerAction(t, view);
+    });
+}
+
+void TableTile::doubleDown()
+{
+    if (busy) return;
+    post([this](Table& t, View& view) {
+        if (!t.inProgress()) return;
+        if (!t.doubleDown()) {
+            view.status = "Not enough balance to double";
+            view.color = "#FF6347";
+            return;
+        }
+        log.log("Player doubles down");
+        afterPlayerAction(t, view);
+    });
+}
+
+void TableTile::split()
+{
+    if (busy) return;
+    post([this](Table& t, View& view) {
+        if (!t.inProgress()) return;
+        if (!t.split()) {
+            view.status = "Only pairs split, up to 4 hands, with the balance for it";
+            view.color = "#FF6347";
+            return;
+        }
+        log.log(QString("Player splits - %1 hands").arg(t.handCount()));
+        afterPlayerAction(t, view);
+    });
+}
+
+void TableTile::surrender()
+{
+    if (busy) return;
+    post([this](Table& t, View& view) {
+        if (!t.inProgress() || !t.canSurrender()) {
+            view.status = "You can only surrender as your first action";
+            return;
+        }
+        settle(t, view, t.surrender());
+    });
+}
+
+void TableTile::apply(const View& view)
+{
+    busy = false;
+    const QString lastStatus = shown.status, lastColor = shown.color;
+    shown = view;
+    if (shown.status.isEmpty()) { // action had nothing to say, keep the old line
+        shown.status = lastStatus;
+        shown.color = lastColor;
+    }
+    dirty = true;
+    refreshIfVisible();
+}
+
+void TableTile::refreshIfVisible()
+{
+    if (!dirty || !isVisible() || window()->isMinimized() || visibleRegion().isEmpty()) return;
+    dirty = false;
+    repaintTable();
+}
+
+void TableTile::repaintTable()
+{
+    TRACE_SCOPE("TableTile::repaintTable", "ui");
+    const bool hideHole = shown.inProgress && !shown.holeRevealed;
+    cardPool.sync(dealerCardLayout, dealerCards, shown.dealer, hideHole);
+    static const Hand noCards;
+    QStringList values;
+    for (int i = 0; i < MAX_HANDS; ++i) {
+        const bool inUse = i < shown.handCount;
+        cardPool.sync(handLayouts[i], playerCards[i], inUse ? shown.player[i] : noCards, false);
+        for (CardView* view : playerCards[i]) {
+            if (view->size() != TILE_CARD_SIZE) view->setFixedSize(TILE_CARD_SIZE);
+        }
+        if (inUse && !shown.player[i].empty()) {
+            // brackets mark the hand being played
+            const QString value = QString::number(shown.player[i].value());
+            values << (shown.handCount > 1 && i == shown.activeHand ? "[" + value + "]" : value);
+        }
+    }
+    for (CardView* view : dealerCards) {
+        if (view->size() != TILE_CARD_SIZE) view->setFixedSize(TILE_CARD_SIZE);
+    }
+
+    dealerLabel->setText(shown.holeRevealed ? QString("Dealer (%1)").arg(shown.dealerValue) : "Dealer");
+    playerLabel->setText(values.isEmpty() ? "Player" : QString("Player (%1)").arg(values.join(" / ")));
+    statusLabel->setText(shown.status);
+    statusLabel->setStyleSheet("color: " + shown.color + ";");
+    balanceLabel->setText(QString("Balance: $%1   Bet: $%2").arg(shown.balance).arg(shown.bet));
+
+    betButton->setEnabled(!shown.inProgress);
+    betBox->setEnabled(!shown.inProgress);
+    hitButton->setEnabled(shown.inProgress && shown.canHit);
+    standButton->setEnabled(shown.inProgress);
+    doubleButton->setEnabled(shown.inProgress && shown.canDouble);
+    splitButton->setEnabled(shown.inProgress && shown.canSplit);
+    surrenderButton->setEnabled(shown.inProgress && shown.canSurrender);
+}
+
+// ---------------- MultiTableWindow ----------------
+
+MultiTableWindow::MultiTableWindow(int tables, int numDecks, QWidget *parent)
+    : QMainWindow(parent)
+{
+    TRACE_SCOPE("MultiTableWindow::MultiTableWindow", "startup");
+    tables = qBound(MIN_TABLES, tables, MAX_TABLES);
+    executor = std::make_unique<TableExecutor>(tables);
+
+    setWindowTitle(QString("Blackjack - %1 tables").arg(tables));
+    setStyleSheet(R"(
+QMainWindow, #grid {
+    background-color: #2E8B57;
+}
+#tableTile {
+    border: 3px solid #8B4513;
+    border-radius: 10px;
+    background-color: rgba(0, 0, 0, 40);
+}
+#tableTile QLabel {
+    color: #FFFFFF;
+}
+#tileTitle {
+    font-weight: bold;
+    font-size: 14px;
+}
+#tileStatus {
+    font-style: italic;
+}
+QPushButton {
+    background-color: #008000;
+    color: #FFFFFF;
+    border: 1px solid #006400;
+    border-radius: 5px;
+    padding: 3px 8px;
+}
+QPushButton:disabled {
+    background-color: #4F7F4F;
+    color: #AAAAAA;
+}
+)");
+
+    Rules rules;
+    rules.numDecks = numDecks;
+
+    auto grid = new QWidget();
+    grid->setObjectName("grid");
+    auto gridLayout = new QGridLayout(grid);
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(tables))));
+    for (int i = 0; i < tables; ++i) {
+        auto tile = new TableTile(i, *executor, cardPool, rules);
+        tiles.append(tile);
+        gridLayout->addWidget(tile, i / columns, i % columns);
+    }
+
+    scrollArea = new QScrollArea();
+    scrollArea->setWidget(grid);
+    scrollArea->setWidgetResizable(true);
+    setCentralWidget(scrollArea);
+    resize(1280, 900);
+
+    // tiles that scroll into view paint whatever they missed
+    connect(scrollArea->verticalScrollBar(), &QScrollBar::valueChanged, this, &MultiTableWindow::refreshVisibleTiles);
+    connect(scrollArea->horizontalScrollBar(), &QScrollBar::valueChanged, this, &MultiTableWindow::refreshVisibleTiles);
+}
+
+MultiTableWindow::~MultiTableWindow()
+{
+    // let every action still queued run while the tiles (and their tables) are alive
+    executor.reset();
+}
+
+void MultiTableWindow::refreshVisibleTiles()
+{
+    for (TableTile* tile : tiles) {
+        tile->refreshIfVisible();
+    }
+}
+
+void MultiTableWindow::changeEvent(QEvent *event)
+{
+    QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) refreshVisibleTiles(); // back from minimized
+}
+
+void MultiTableWindow::resizeEvent(QResizeEvent *event)
+{
+    QMainWindow::resizeEvent(event);
+    refreshVisibleTiles();
+}
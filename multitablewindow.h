@@ -0,0 +1,130 @@
+#ifndef MULTITABLEWINDOW_H
+#define MULTITABLEWINDOW_H
+
+#include <QFrame>
+#include <QMainWindow>
+#include <QVector>
+#include <QString>
+#include <functional>
+#include <memory>
+#include "table.h"
+#include "tableexecutor.h"
+#include "eventlogger.h"
+#include "cardview.h"
+
+class QLabel;
+class QHBoxLayout;
+class QPushButton;
+class QScrollArea;
+class QSpinBox;
+
+// One table in the grid. The Table and its log belong to the tile, but
+// the Table is only ever touched on the tile's strand of the executor:
+// the buttons post an action there, and the action sends back a copy of
+// what the tile should show. Updates that arrive while the tile is
+// scrolled out of view are kept and painted once it comes back.
+class TableTile : public QFrame
+{
+    Q_OBJECT
+public:
+    TableTile(int index, TableExecutor& executor, CardViewPool& cardPool, const Rules& rules, QWidget *parent = nullptr);
+
+    // paint the last update if there is one waiting and the tile is on screen
+    void refreshIfVisible();
+
+    static constexpr int DEFAULT_BALANCE = 10000;
+
+private:
+    // What the tile shows, copied out of the Table on its strand
+    struct View {
+        long long balance = 0;
+        int bet = 0;
+        bool inProgress = false;
+        bool holeRevealed = false;
+        bool canHit = false;
+        bool canDouble = false;
+        bool canSplit = false;
+        bool canSurrender = false;
+        int handCount = 1;
+        int activeHand = 0;
+        int dealerValue = 0;
+        Hand player[MAX_HANDS];
+        Hand dealer;
+        QString status;
+        QString color;
+    };
+
+    // runs action on the table's strand, then shows the result here
+    void post(std::function<void(Table&, View&)> action);
+    void apply(const View& view);
+    void repaintTable();
+
+    static View viewOf(const Table& table);
+    // next hand, or the dealer and the settlement once every hand is played
+    void afterPlayerAction(Table& table, View& view);
+    void settle(Table& table, View& view, const RoundResult& result);
+
+    int index;
+    TableExecutor& executor;
+    CardViewPool& cardPool;
+
+    Table table;      // strand only
+    EventLogger log;  // game_log_table<N>.txt
+
+    View shown;
+    bool dirty = false;
+    bool busy = false; // an action is on its way, ignore clicks until it's back
+
+    QLabel* dealerLabel;
+    QLabel* playerLabel;
+    QLabel* statusLabel;
+    QLabel* balanceLabel;
+    QHBoxLayout* dealerCardLayout;
+    QHBoxLayout* playerCardLayout;
+    QHBoxLayout* handLayouts[MAX_HANDS];
+    QVector<CardView*> dealerCards;
+    QVector<CardView*> playerCards[MAX_HANDS];
+    QSpinBox* betBox;
+    QPushButton* betButton;
+    QPushButton* hitButton;
+    QPushButton* standButton;
+    QPushButton* doubleButton;
+    QPushButton* splitButton;
+    QPushButton* surrenderButton;
+
+private slots:
+    void placeBet();
+    void hit();
+    void stand();
+    void doubleDown();
+    void split();
+    void surrender();
+};
+
+// Grid of independent tables (blackjack_twist --tables N). Each table
+// has its own shoe, balance and log; their engines share a small thread
+// pool and only the tiles in view repaint.
+class MultiTableWindow : public QMainWindow
+{
+    Q_OBJECT
+public:
+    explicit MultiTableWindow(int tables, int numDecks, QWidget *parent = nullptr);
+    ~MultiTableWindow();
+
+    static constexpr int MIN_TABLES = 4;
+    static constexpr int MAX_TABLES = 16;
+
+protected:
+    void changeEvent(QEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void refreshVisibleTiles();
+
+    CardViewPool cardPool;
+    std::unique_ptr<TableExecutor> executor;
+    QScrollArea* scrollArea;
+    QVector<TableTile*> tiles;
+};
+
+#endif // MULTITABLEWINDOW_H
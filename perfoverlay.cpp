@@ -0,0 +1,72 @@
+#include "perfoverlay.h"
+#include <QDateTime>
+#include <QFile>
+#include <QFontDatabase>
+#include <QTextStream>
+
+PerfOverlay::PerfOverlay(QWidget *parent)
+    : QLabel(parent)
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setStyleSheet("background-color: rgba(0, 0, 0, 180); color: #7CFC00; padding: 6px; border-radius: 4px;");
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setTextFormat(Qt::PlainText);
+    hide();
+
+    refreshTimer.setInterval(250);
+    connect(&refreshTimer, &QTimer::timeout, this, &PerfOverlay::refresh);
+}
+
+void PerfOverlay::addSource(const QString& name, const LatencyHistogram* histogram)
+{
+    sources.append(Source{name, histogram});
+}
+
+QString PerfOverlay::report() const
+{
+    // microseconds, one decimal
+    auto us = [](double ns) { return QString::number(ns / 1000.0, 'f', 1).rightJustified(9); };
+
+    QString text = QString("%1 %2 %3 %4 %5 %6 %7\n")
+                       .arg("", -18).arg("count", 7).arg("p50 us", 9).arg("p90 us", 9)
+                       .arg("p99 us", 9).arg("max us", 9).arg("mean us", 9);
+    for (const Source& s : sources) {
+        const LatencyHistogram& h = *s.histogram;
+        text += QString("%1 %2 %3 %4 %5 %6 %7\n")
+                    .arg(s.name, -18)
+                    .arg(static_cast<qulonglong>(h.count()), 7)
+                    .arg(us(h.percentile(50)), us(h.percentile(90)), us(h.percentile(99)),
+                         us(static_cast<double>(h.max())), us(h.mean()));
+    }
+    return text;
+}
+
+bool PerfOverlay::dump(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) return false;
+
+    QTextStream out(&file);
+    out << "# " << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss") << "\n" << report() << "\n";
+    return true;
+}
+
+void PerfOverlay::toggle()
+{
+    if (isVisible()) {
+        refreshTimer.stop();
+        hide();
+    } else {
+        refresh();
+        show();
+        raise();
+        refreshTimer.start();
+    }
+}
+
+void PerfOverlay::refresh()
+{
+    setText(report().trimmed() + "\n\nF12 hide   Ctrl+F12 dump to latency.txt");
+    adjustSize();
+    move(10, 10);
+}
@@ -0,0 +1,39 @@
+#ifndef PERFOVERLAY_H
+#define PERFOVERLAY_H
+
+#include <QLabel>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include "latencyhistogram.h"
+
+// Debug overlay listing latency percentiles for a set of histograms.
+// Sits on top of its parent, ignores the mouse, and only refreshes while
+// it is visible.
+class PerfOverlay : public QLabel
+{
+    Q_OBJECT
+public:
+    struct Source {
+        QString name;
+        const LatencyHistogram* histogram;
+    };
+
+    explicit PerfOverlay(QWidget *parent = nullptr);
+
+    void addSource(const QString& name, const LatencyHistogram* histogram);
+
+    // plain text table of every source, same as the overlay shows
+    QString report() const;
+    bool dump(const QString& path) const;
+
+public slots:
+    void toggle();
+    void refresh();
+
+private:
+    QVector<Source> sources;
+    QTimer refreshTimer;
+};
+
+#endif // PERFOVERLAY_H
@@ -0,0 +1,135 @@
+// blackjack_replay - re-runs recorded sessions headlessly and checks the
+// balances against the recording.
+//
+//   blackjack_replay [--repeat N] FILE...
+//   blackjack_replay --generate ROUNDS [--seed S] [--decks D] FILE
+//
+// The game writes one session-*.bjr per run next to game_log.txt.
+// --repeat replays each file N times (for timing). --generate records a
+// synthetic basic strategy session, handy as a fixed benchmark input.
+
+#include "session.h"
+#include "strategy.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+void usage()
+{
+    std::fprintf(stderr,
+                 "usage: blackjack_replay [--repeat N] FILE...\n"
+                 "       blackjack_replay --generate ROUNDS [--seed S] [--decks D] FILE\n");
+}
+
+bool readFile(const char* path, std::vector<std::uint8_t>& data)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int generate(long long rounds, std::uint64_t seed, int decks, const char* path)
+{
+    SessionRecorder recorder;
+    Table table;
+    table.setRecorder(&recorder);
+
+    Rules rules;
+    rules.numDecks = decks;
+    table.setRules(rules);
+    table.seed(seed);
+    table.setBalance(1000000000LL);
+
+    BasicStrategyPolicy policy;
+    for (long long i = 0; i < rounds; ++i) {
+        table.playRound(10, policy);
+    }
+
+    std::vector<std::uint8_t> bytes;
+    recorder.takeBytes(bytes);
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+        std::fprintf(stderr, "%s: can't write\n", path);
+        return 1;
+    }
+    std::printf("%s: %lld rounds, %zu bytes, final balance %lld\n", path, rounds, bytes.size(), table.balance());
+    return 0;
+}
+
+int replay(const char* path, int repeat)
+{
+    std::vector<std::uint8_t> data;
+    if (!readFile(path, data)) {
+        std::fprintf(stderr, "%s: can't read\n", path);
+        return 1;
+    }
+
+    ReplayResult result;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i) {
+        result = replaySession(data.data(), data.size());
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!result.ok) {
+        std::printf("%s: FAILED at round %lld: %s (balance %lld)\n",
+                    path, result.failedAtRound, result.error.c_str(), result.finalBalance);
+        return 1;
+    }
+
+    const double rounds = static_cast<double>(result.rounds) * repeat;
+    std::printf("%s: ok, %lld rounds, %lld ops, final balance %lld, net %lld, %.2f M rounds/s\n",
+                path, result.rounds, result.ops, result.finalBalance, result.stats.net,
+                seconds > 0 ? rounds / seconds / 1e6 : 0.0);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int repeat = 1;
+    long long generateRounds = 0;
+    std::uint64_t seed = 1;
+    int decks = 6;
+    std::vector<const char*> files;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (!std::strcmp(arg, "--repeat") && hasValue) repeat = std::atoi(argv[++i]);
+        else if (!std::strcmp(arg, "--generate") && hasValue) generateRounds = std::strtoll(argv[++i], nullptr, 10);
+        else if (!std::strcmp(arg, "--seed") && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(arg, "--decks") && hasValue) decks = std::atoi(argv[++i]);
+        else if (arg[0] == '-') {
+            usage();
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty() || repeat < 1 || (generateRounds > 0 && files.size() != 1)) {
+        usage();
+        return 1;
+    }
+
+    if (generateRounds > 0) {
+        return generate(generateRounds, seed, decks, files[0]);
+    }
+
+    int status = 0;
+    for (const char* path : files) {
+        status |= replay(path, repeat);
+    }
+    return status;
+}
@@ -0,0 +1,159 @@
+#include "ruleexplorer.h"
+#include "ruleset.h"
+#include "strategy.h"
+#include "workstealingpool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// bump when a change to the engine or to basic strategy changes results,
+// so old cache entries stop matching
+constexpr int CACHE_VERSION = 3;
+
+} // namespace
+
+std::vector<Rules> ExploreConfig::grid() const
+{
+    std::vector<Rules> out;
+    for (int d : decks) {
+        for (int target : dealerTargets) {
+            for (bool s : surrender) {
+                for (const auto& pay : payouts) {
+                    Rules r = base;
+                    r.numDecks = d;
+                    r.dealerTarget = target;
+                    r.allowSurrender = s;
+                    r.blackjackPayNum = pay.first;
+                    r.blackjackPayDen = pay.second;
+                    out.push_back(r);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+double ExploreCell::confidence95() const
+{
+    if (stats.rounds < 2 || stats.wagered == 0) return 0.0;
+    const double averageBet = static_cast<double>(stats.wagered) / stats.rounds;
+    return 1.96 * std::sqrt(stats.variancePerRound() / stats.rounds) / averageBet;
+}
+
+// ---------------- ExploreCache ----------------
+//
+// Text file, one cell per line: the key, then the RoundStats fields.
+// Doubles are written with 17 digits so they read back exactly.
+
+std::string ExploreCache::key(const Rules& r, const ExploreConfig& c)
+{
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "v%d d%d p%.17g t%d bj%d/%d dbl%d sur%d spl%d mh%d das%d rsa%d hsa%d csm%d r%lld c%lld s%llu b%d",
+                  CACHE_VERSION, r.numDecks, r.penetration, r.dealerTarget, r.blackjackPayNum, r.blackjackPayDen,
+                  r.allowDouble, r.allowSurrender, r.allowSplit, r.maxHands, r.doubleAfterSplit, r.resplitAces,
+                  r.hitSplitAces, r.continuousShuffle, static_cast<long long>(c.rounds),
+                  static_cast<long long>(c.chunkRounds), static_cast<unsigned long long>(c.seed), c.bet);
+    return buf;
+}
+
+void ExploreCache::load(const std::string& path)
+{
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        const std::size_t bar = line.find('|');
+        if (line.empty() || line[0] == '#' || bar == std::string::npos) continue;
+
+        RoundStats s;
+        std::istringstream fields(line.substr(bar + 1));
+        if (fields >> s.rounds >> s.wagered >> s.net >> s.netSquared >> s.wins >> s.losses >> s.pushes) {
+            cells[line.substr(0, bar)] = s;
+        }
+    }
+}
+
+bool ExploreCache::save(const std::string& path) const
+{
+    // whole file rewritten; a crash mid-write loses the cache, not results
+    std::ofstream out(path, std::ios::trunc);
+    out << "# blackjack_explore cache: key|rounds wagered net netSquared wins losses pushes\n";
+    char buf[64];
+    for (const auto& [k, s] : cells) {
+        std::snprintf(buf, sizeof(buf), "%.17g", s.netSquared);
+        out << k << '|' << s.rounds << ' ' << s.wagered << ' ' << s.net << ' ' << buf << ' '
+            << s.wins << ' ' << s.losses << ' ' << s.pushes << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+bool ExploreCache::find(const Rules& rules, const ExploreConfig& config, RoundStats& stats) const
+{
+    const auto it = cells.find(key(rules, config));
+    if (it == cells.end()) return false;
+    stats = it->second;
+    return true;
+}
+
+void ExploreCache::store(const Rules& rules, const ExploreConfig& config, const RoundStats& stats)
+{
+    cells[key(rules, config)] = stats;
+}
+
+// ---------------- exploreRules ----------------
+
+ExploreResult exploreRules(const ExploreConfig& config, ExploreCache* cache)
+{
+    ExploreResult result;
+    for (const Rules& r : config.grid()) {
+        ExploreCell cell;
+        cell.rules = r;
+        cell.cached = cache && cache->find(r, config, cell.stats);
+        result.cells.push_back(cell);
+    }
+
+    std::vector<int> todo;
+    for (int i = 0; i < static_cast<int>(result.cells.size()); ++i) {
+        if (!result.cells[i].cached) todo.push_back(i);
+    }
+
+    const std::int64_t chunk = config.chunkRounds > 0 ? config.chunkRounds : 1;
+    const std::int64_t chunksPerCell = (config.rounds + chunk - 1) / chunk;
+    std::vector<RoundStats> partial(todo.size() * static_cast<std::size_t>(chunksPerCell));
+
+    WorkStealingPool pool(config.threads);
+    result.threads = pool.threadCount();
+    const auto start = std::chrono::steady_clock::now();
+
+    // task = (cell, chunk), chunk-major so the first tasks out spread over
+    // every variant
+    pool.run(static_cast<std::int64_t>(partial.size()), [&](std::int64_t task, int) {
+        const std::size_t cellIndex = static_cast<std::size_t>(task % static_cast<std::int64_t>(todo.size()));
+        const std::int64_t chunkIndex = task / static_cast<std::int64_t>(todo.size());
+        const Rules& rules = result.cells[todo[cellIndex]].rules;
+
+        Table table(rules);
+        table.seed(config.seed, static_cast<std::uint64_t>(chunkIndex)); // same shoes for every variant
+        const std::int64_t n = std::min(chunk, config.rounds - chunkIndex * chunk);
+        partial[cellIndex * chunksPerCell + chunkIndex] = withRuleSet(rules, [&](auto ruleSet) {
+            return table.playRounds<decltype(ruleSet)>(n, BasicStrategyPolicy(), config.bet);
+        });
+    });
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (std::size_t i = 0; i < todo.size(); ++i) {
+        ExploreCell& cell = result.cells[todo[i]];
+        for (std::int64_t c = 0; c < chunksPerCell; ++c) {
+            cell.stats.merge(partial[i * chunksPerCell + c]); // chunk order, reproducible
+        }
+        result.roundsPlayed += cell.stats.rounds;
+        if (cache) cache->store(cell.rules, config, cell.stats);
+    }
+    return result;
+}
@@ -0,0 +1,76 @@
+#ifndef RULEEXPLORER_H
+#define RULEEXPLORER_H
+
+#include "table.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// House edge over a grid of rule variants, with basic strategy.
+//
+// Every (variant, chunk) pair is one task on a single WorkStealingPool,
+// so all cores stay busy to the end of the sweep instead of idling
+// between variants. Chunk i of every variant is seeded with
+// (seed, i): variants with the same deck count are dealt the same shoes
+// (common random numbers), so differences between them are far less
+// noisy than the edges themselves.
+//
+// Finished cells go into an ExploreCache keyed by the rules and the run
+// settings; a later sweep only plays the cells it doesn't find there.
+
+struct ExploreConfig {
+    Rules base;                      // everything the grid doesn't vary
+    std::vector<int> decks = { 1, 2, 4, 6, 8 };
+    std::vector<int> dealerTargets = { 17, 18 };
+    std::vector<bool> surrender = { true, false };
+    std::vector<std::pair<int, int>> payouts = { { 3, 2 }, { 6, 5 } };
+
+    std::int64_t rounds = 2000000;   // per variant
+    std::int64_t chunkRounds = 1 << 18;
+    int threads = 0;                 // 0 = all hardware threads
+    std::uint64_t seed = 1;
+    int bet = 10;                    // a multiple of 10 so 3:2, 6:5 and surrender pay exactly
+
+    std::vector<Rules> grid() const;
+};
+
+struct ExploreCell {
+    Rules rules;
+    RoundStats stats;
+    bool cached = false;
+
+    double houseEdge() const { return stats.houseEdge(); }
+    double confidence95() const; // of the house edge
+};
+
+class ExploreCache
+{
+public:
+    // missing or unreadable files give an empty cache
+    void load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    bool find(const Rules& rules, const ExploreConfig& config, RoundStats& stats) const;
+    void store(const Rules& rules, const ExploreConfig& config, const RoundStats& stats);
+
+    std::size_t size() const { return cells.size(); }
+
+private:
+    static std::string key(const Rules& rules, const ExploreConfig& config);
+
+    std::map<std::string, RoundStats> cells;
+};
+
+struct ExploreResult {
+    std::vector<ExploreCell> cells; // in grid() order
+    int threads = 1;
+    double seconds = 0.0;
+    std::int64_t roundsPlayed = 0;  // 0 if everything came from the cache
+};
+
+// cache may be null
+ExploreResult exploreRules(const ExploreConfig& config, ExploreCache* cache);
+
+#endif // RULEEXPLORER_H
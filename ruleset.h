@@ -0,0 +1,76 @@
+#ifndef RULESET_H
+#define RULESET_H
+
+#include "table.h"
+
+// Rules fixed at compile time. A Table round played with a RuleSet reads
+// the dealer target, the natural's payout, double after split and
+// surrender from here instead of from Rules, so they fold into the round
+// loop as constants (the payout division becomes a multiply and shift).
+// The rest (splitting, deck count, penetration) stays in Rules; nothing
+// in the round loop branches on the deck count anyway.
+//
+// That doesn't make the loop measurably faster today: the rule branches
+// are perfectly predicted within a run, and a round's time goes on the
+// shuffle, the card draws and the policy (play_round_specialized in
+// blackjack_bench tracks it against play_round). It is kept because the
+// cost is only compile time, 16 instantiations of the loop reached
+// through withRuleSet, and totals match DynamicRuleSet exactly.
+//
+// A RuleSet has to agree with the table's Rules (see matches); use
+// withRuleSet to get the one that does.
+template <int DealerTarget, int PayNum, int PayDen, bool DoubleAfterSplit, bool Surrender>
+struct RuleSet {
+    static constexpr int dealerTarget(const Rules&) { return DealerTarget; }
+    static constexpr int blackjackPayNum(const Rules&) { return PayNum; }
+    static constexpr int blackjackPayDen(const Rules&) { return PayDen; }
+    static constexpr bool doubleAfterSplit(const Rules&) { return DoubleAfterSplit; }
+    static constexpr bool allowSurrender(const Rules&) { return Surrender; }
+
+    static bool matches(const Rules& r)
+    {
+        return r.dealerTarget == DealerTarget && r.blackjackPayNum == PayNum && r.blackjackPayDen == PayDen
+            && r.doubleAfterSplit == DoubleAfterSplit && r.allowSurrender == Surrender;
+    }
+};
+
+namespace RuleSetDispatch {
+
+template <int Target, int Num, int Den, bool Das, typename F>
+auto bySurrender(const Rules& r, F&& f)
+{
+    return r.allowSurrender ? f(RuleSet<Target, Num, Den, Das, true>{})
+                            : f(RuleSet<Target, Num, Den, Das, false>{});
+}
+
+template <int Target, int Num, int Den, typename F>
+auto byDoubleAfterSplit(const Rules& r, F&& f)
+{
+    return r.doubleAfterSplit ? bySurrender<Target, Num, Den, true>(r, f)
+                              : bySurrender<Target, Num, Den, false>(r, f);
+}
+
+template <int Target, typename F>
+auto byPayout(const Rules& r, F&& f)
+{
+    if (r.blackjackPayNum == 6 && r.blackjackPayDen == 5) return byDoubleAfterSplit<Target, 6, 5>(r, f);
+    return byDoubleAfterSplit<Target, 3, 2>(r, f);
+}
+
+} // namespace RuleSetDispatch
+
+// Calls f with the RuleSet matching rules: dealer to 17 or 18, naturals
+// paying 3:2 or 6:5, double after split and surrender on or off. Rules
+// outside those get f(DynamicRuleSet()), the same code reading Rules.
+// f is instantiated for all of them, so keep it to the hot loop.
+template <typename F>
+auto withRuleSet(const Rules& r, F&& f)
+{
+    const bool payoutKnown = (r.blackjackPayNum == 3 && r.blackjackPayDen == 2)
+                          || (r.blackjackPayNum == 6 && r.blackjackPayDen == 5);
+    if (payoutKnown && r.dealerTarget == 17) return RuleSetDispatch::byPayout<17>(r, f);
+    if (payoutKnown && r.dealerTarget == 18) return RuleSetDispatch::byPayout<18>(r, f);
+    return f(DynamicRuleSet());
+}
+
+#endif // RULESET_H
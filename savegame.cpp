@@ -0,0 +1,293 @@
+#include "savegame.h"
+#include <array>
+#include <cstring>
+
+namespace {
+
+std::array<std::uint32_t, 256> makeCrcTable()
+{
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+const std::array<std::uint32_t, 256> crcTable = makeCrcTable();
+
+} // namespace
+
+const char* saveErrorText(SaveError error)
+{
+    switch (error) {
+    case SaveError::None:               return "ok";
+    case SaveError::TooShort:           return "file is truncated";
+    case SaveError::BadMagic:           return "not a save file";
+    case SaveError::UnsupportedVersion: return "save was made by a newer version";
+    case SaveError::BadChecksum:        return "checksum mismatch, file is damaged";
+    case SaveError::Corrupt:            return "save contents are invalid";
+    }
+    return "unknown error";
+}
+
+std::uint32_t crc32(const std::uint8_t* data, std::size_t size, std::uint32_t crc)
+{
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+std::vector<std::uint8_t> encodeSave(const SaveGame& save)
+{
+    std::vector<std::uint8_t> out;
+    encodeSave(save, out);
+    return out;
+}
+
+void encodeSave(const SaveGame& save, std::vector<std::uint8_t>& out)
+{
+    static_assert(sizeof(Card) == 1, "cards are written as raw bytes");
+    // header fields are stored in host order; every platform we ship on is little endian
+
+    const TableSnapshot& t = save.table;
+
+    SaveHeader h{};
+    std::memcpy(h.magic, "BJSV", 4);
+    h.version = SAVE_VERSION;
+    h.headerSize = sizeof(SaveHeader);
+    h.balance = t.balance;
+    h.currentBet = t.currentBet;
+    h.difficulty = static_cast<std::uint8_t>(save.difficulty);
+    h.numDecks = static_cast<std::uint8_t>(t.numDecks);
+    h.flags = (t.inProgress ? InProgress : 0) | (t.holeCardRevealed ? HoleCardRevealed : 0)
+            | (t.canSurrender ? CanSurrender : 0);
+    h.shoeCount = static_cast<std::uint16_t>(t.shoe.size());
+    h.playerCount = static_cast<std::uint8_t>(t.player.size());
+    h.dealerCount = static_cast<std::uint8_t>(t.dealer.size());
+    h.sequence = save.sequence;
+
+    const bool split = !t.splitHands.empty() && t.handBets.size() == t.splitHands.size() + 1;
+    std::size_t splitBytes = 0;
+    if (split) {
+        h.handCount = static_cast<std::uint8_t>(t.handBets.size());
+        for (const Hand& hand : t.splitHands) splitBytes += 1 + hand.size();
+        splitBytes += 4 * t.handBets.size() + 1;
+    }
+    h.payloadSize = static_cast<std::uint32_t>(t.shoe.size() + t.player.size() + t.dealer.size()
+                                               + splitBytes + save.folderPath.size());
+
+    out.resize(sizeof(SaveHeader) + h.payloadSize);
+    std::uint8_t* p = out.data() + sizeof(SaveHeader);
+    std::memcpy(p, t.shoe.data(), t.shoe.size());       p += t.shoe.size();
+    std::memcpy(p, t.player.data(), t.player.size());   p += t.player.size();
+    std::memcpy(p, t.dealer.data(), t.dealer.size());   p += t.dealer.size();
+    if (split) {
+        for (const Hand& hand : t.splitHands) {
+            *p++ = static_cast<std::uint8_t>(hand.size());
+            std::memcpy(p, hand.data(), hand.size());
+            p += hand.size();
+        }
+        for (int stake : t.handBets) {
+            const std::int32_t v = stake;
+            std::memcpy(p, &v, 4);
+            p += 4;
+        }
+        *p++ = static_cast<std::uint8_t>(t.activeHand);
+    }
+    std::memcpy(p, save.folderPath.data(), save.folderPath.size());
+
+    h.crc = crc32(out.data() + sizeof(SaveHeader), h.payloadSize);
+    std::memcpy(out.data(), &h, sizeof(SaveHeader));
+}
+
+SaveError decodeSave(const std::uint8_t* data, std::size_t size, SaveGame& save)
+{
+    if (size < sizeof(SaveHeader)) return SaveError::TooShort;
+
+    SaveHeader h;
+    std::memcpy(&h, data, sizeof(SaveHeader));
+
+    if (std::memcmp(h.magic, "BJSV", 4) != 0) return SaveError::BadMagic;
+    if (h.version > SAVE_VERSION) return SaveError::UnsupportedVersion;
+    if (h.headerSize < sizeof(SaveHeader) || size < static_cast<std::size_t>(h.headerSize) + h.payloadSize) {
+        return SaveError::TooShort;
+    }
+
+    const std::uint8_t* payload = data + h.headerSize;
+    if (crc32(payload, h.payloadSize) != h.crc) return SaveError::BadChecksum;
+
+    const std::size_t cards = std::size_t(h.shoeCount) + h.playerCount + h.dealerCount;
+    if (cards > h.payloadSize || h.numDecks < 1 || h.difficulty > 2) return SaveError::Corrupt;
+
+    auto validCards = [](const std::uint8_t* from, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            const Card c{from[i]};
+            if (c.rank() < 1 || c.rank() > 13 || c.suit() > Card::Spades) return false;
+        }
+        return true;
+    };
+    auto readHand = [&](const std::uint8_t* from, std::size_t n, Hand& to) {
+        Card buffer[Hand::MAX_CARDS];
+        if (n > Hand::MAX_CARDS || !validCards(from, n)) return false;
+        std::memcpy(buffer, from, n);
+        return to.assign(buffer, static_cast<int>(n));
+    };
+
+    TableSnapshot& t = save.table;
+    const std::uint8_t* p = payload;
+    const std::uint8_t* const end = payload + h.payloadSize;
+    if (!validCards(p, h.shoeCount)) return SaveError::Corrupt;
+    t.shoe.resize(h.shoeCount);
+    std::memcpy(t.shoe.data(), p, h.shoeCount);
+    p += h.shoeCount;
+    if (!readHand(p, h.playerCount, t.player)) return SaveError::Corrupt;
+    p += h.playerCount;
+    if (!readHand(p, h.dealerCount, t.dealer)) return SaveError::Corrupt;
+    p += h.dealerCount;
+
+    t.splitHands.clear();
+    t.handBets.clear();
+    t.activeHand = 0;
+    if (h.version >= 2 && h.handCount > 1) {
+        if (h.handCount > MAX_HANDS) return SaveError::Corrupt;
+        t.splitHands.resize(h.handCount - 1);
+        for (Hand& hand : t.splitHands) {
+            if (p == end) return SaveError::Corrupt;
+            const std::size_t n = *p++;
+            if (static_cast<std::size_t>(end - p) < n || !readHand(p, n, hand)) return SaveError::Corrupt;
+            p += n;
+        }
+        if (static_cast<std::size_t>(end - p) < 4u * h.handCount + 1) return SaveError::Corrupt;
+        for (int i = 0; i < h.handCount; ++i) {
+            std::int32_t stake;
+            std::memcpy(&stake, p, 4);
+            p += 4;
+            t.handBets.push_back(stake);
+        }
+        t.activeHand = *p++;
+        if (t.activeHand > h.handCount) return SaveError::Corrupt;
+    }
+    save.folderPath.assign(reinterpret_cast<const char*>(p), static_cast<std::size_t>(end - p));
+
+    save.difficulty = h.difficulty;
+    save.sequence = h.sequence;
+    t.balance = h.balance;
+    t.currentBet = h.currentBet;
+    t.numDecks = h.numDecks;
+    t.inProgress = h.flags & InProgress;
+    t.holeCardRevealed = h.flags & HoleCardRevealed;
+    t.canSurrender = h.flags & CanSurrender;
+    return SaveError::None;
+}
+
+// ---------------- Autosave journal ----------------
+
+namespace {
+
+// record layout: magic, payload size, crc, then the payload
+struct JournalRecordHeader {
+    char magic[4];              // "BJJR"
+    std::uint32_t payloadSize;
+    std::uint32_t crc;
+};
+
+struct JournalPayload {
+    std::uint32_t sequence;
+    std::int32_t currentBet;
+    std::int64_t balance;
+    std::uint16_t cardsConsumed;
+    std::uint8_t flags;
+    std::uint8_t playerCount;
+    std::uint8_t dealerCount;
+    std::uint8_t reserved[7];
+};
+static_assert(sizeof(JournalRecordHeader) == 12, "journal layout is part of the file format");
+static_assert(sizeof(JournalPayload) == 32, "journal layout is part of the file format");
+
+} // namespace
+
+void appendJournalEntry(const JournalEntry& entry, std::vector<std::uint8_t>& out)
+{
+    JournalPayload body{};
+    body.sequence = entry.sequence;
+    body.currentBet = entry.currentBet;
+    body.balance = entry.balance;
+    body.cardsConsumed = entry.cardsConsumed;
+    body.flags = entry.flags;
+    body.playerCount = static_cast<std::uint8_t>(entry.player.size());
+    body.dealerCount = static_cast<std::uint8_t>(entry.dealer.size());
+
+    JournalRecordHeader h{};
+    std::memcpy(h.magic, "BJJR", 4);
+    h.payloadSize = static_cast<std::uint32_t>(sizeof(body) + entry.player.size() + entry.dealer.size());
+
+    const std::size_t start = out.size();
+    out.resize(start + sizeof(h) + h.payloadSize);
+    std::uint8_t* p = out.data() + start + sizeof(h);
+    std::memcpy(p, &body, sizeof(body));
+    p += sizeof(body);
+    std::memcpy(p, entry.player.data(), entry.player.size());
+    p += entry.player.size();
+    std::memcpy(p, entry.dealer.data(), entry.dealer.size());
+
+    h.crc = crc32(out.data() + start + sizeof(h), h.payloadSize);
+    std::memcpy(out.data() + start, &h, sizeof(h));
+}
+
+std::size_t readJournal(const std::uint8_t* data, std::size_t size, std::vector<JournalEntry>& entries)
+{
+    std::size_t pos = 0;
+    while (size - pos >= sizeof(JournalRecordHeader)) {
+        JournalRecordHeader h;
+        std::memcpy(&h, data + pos, sizeof(h));
+        if (std::memcmp(h.magic, "BJJR", 4) != 0) break;
+        if (h.payloadSize < sizeof(JournalPayload) || size - pos - sizeof(h) < h.payloadSize) break;
+
+        const std::uint8_t* payload = data + pos + sizeof(h);
+        if (crc32(payload, h.payloadSize) != h.crc) break;
+
+        JournalPayload body;
+        std::memcpy(&body, payload, sizeof(body));
+        if (sizeof(body) + body.playerCount + body.dealerCount != h.payloadSize) break;
+
+        JournalEntry e;
+        e.sequence = body.sequence;
+        e.balance = body.balance;
+        e.currentBet = body.currentBet;
+        e.flags = body.flags;
+        e.cardsConsumed = body.cardsConsumed;
+        Card cards[2 * Hand::MAX_CARDS];
+        if (body.playerCount > Hand::MAX_CARDS || body.dealerCount > Hand::MAX_CARDS) break;
+        std::memcpy(cards, payload + sizeof(body), body.playerCount + body.dealerCount);
+        e.player.assign(cards, body.playerCount);
+        e.dealer.assign(cards + body.playerCount, body.dealerCount);
+        entries.push_back(std::move(e));
+
+        pos += sizeof(h) + h.payloadSize;
+    }
+    return pos;
+}
+
+bool applyJournalEntry(const JournalEntry& entry, TableSnapshot& snapshot)
+{
+    if (entry.cardsConsumed > snapshot.shoe.size()) return false;
+
+    snapshot.shoe.erase(snapshot.shoe.begin(), snapshot.shoe.begin() + entry.cardsConsumed);
+    snapshot.balance = entry.balance;
+    snapshot.currentBet = entry.currentBet;
+    snapshot.inProgress = entry.flags & InProgress;
+    snapshot.holeCardRevealed = entry.flags & HoleCardRevealed;
+    snapshot.canSurrender = entry.flags & CanSurrender;
+    snapshot.player = entry.player;
+    snapshot.dealer = entry.dealer;
+    snapshot.splitHands.clear();
+    snapshot.handBets.clear();
+    snapshot.activeHand = 0;
+    return true;
+}
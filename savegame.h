@@ -0,0 +1,101 @@
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include "table.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary save snapshot.
+//
+//   SaveHeader (40 bytes, little endian, fixed layout)
+//   shoe cards, player cards, dealer cards   (one packed byte each)
+//   split block, only if handCount > 1:
+//     hands 2..n as card count + cards, int32 stake per hand, active hand byte
+//   folder path                               (UTF-8, not terminated)
+//
+// The CRC-32 covers everything after the header. Decoding reads the
+// header with one memcpy and the cards straight out of the buffer, so a
+// memory mapped file loads without any parsing.
+
+struct SaveGame {
+    int difficulty = 0;
+    std::string folderPath;
+    TableSnapshot table;
+    std::uint32_t sequence = 0;   // autosave checkpoint number, 0 for manual saves
+};
+
+enum class SaveError {
+    None,
+    TooShort,
+    BadMagic,
+    UnsupportedVersion,
+    BadChecksum,
+    Corrupt
+};
+
+const char* saveErrorText(SaveError error);
+
+struct SaveHeader {
+    char magic[4];              // "BJSV"
+    std::uint16_t version;
+    std::uint16_t headerSize;
+    std::uint32_t payloadSize;  // bytes after the header
+    std::uint32_t crc;          // CRC-32 of the payload
+    std::int64_t balance;
+    std::int32_t currentBet;
+    std::uint8_t difficulty;
+    std::uint8_t numDecks;
+    std::uint8_t flags;         // SaveFlags
+    std::uint8_t playerCount;
+    std::uint16_t shoeCount;
+    std::uint8_t dealerCount;
+    std::uint8_t handCount;     // player hands, 0 or 1 unless split (reserved in version 1)
+    std::uint32_t sequence;     // SaveGame::sequence
+};
+static_assert(sizeof(SaveHeader) == 40, "SaveHeader layout is part of the file format");
+
+enum SaveFlags : std::uint8_t {
+    InProgress = 1 << 0,
+    HoleCardRevealed = 1 << 1,
+    CanSurrender = 1 << 2
+};
+
+constexpr std::uint16_t SAVE_VERSION = 2; // 2 added the split block, 1 still loads
+
+std::uint32_t crc32(const std::uint8_t* data, std::size_t size, std::uint32_t crc = 0);
+
+std::vector<std::uint8_t> encodeSave(const SaveGame& save);
+void encodeSave(const SaveGame& save, std::vector<std::uint8_t>& out); // reuses out's capacity
+SaveError decodeSave(const std::uint8_t* data, std::size_t size, SaveGame& save);
+
+// ---------------- Autosave journal ----------------
+//
+// Between full snapshots the autosave appends one small record per round
+// with only what changed: balance, bet, flags, how many cards came off
+// the front of the shoe, and the two hands. Each record carries its own
+// length and CRC, so a record torn by a crash is detected and the replay
+// stops cleanly in front of it. Only the first hand is journaled; rounds
+// that were split go into a full snapshot instead.
+
+struct JournalEntry {
+    std::uint32_t sequence = 0;   // follows on from the snapshot's sequence
+    std::int64_t balance = 0;
+    std::int32_t currentBet = 0;
+    std::uint8_t flags = 0;       // SaveFlags
+    std::uint16_t cardsConsumed = 0;
+    Hand player;
+    Hand dealer;
+};
+
+void appendJournalEntry(const JournalEntry& entry, std::vector<std::uint8_t>& out);
+
+// Reads records until the data ends or a record doesn't check out.
+// Returns the number of bytes that held valid records.
+std::size_t readJournal(const std::uint8_t* data, std::size_t size, std::vector<JournalEntry>& entries);
+
+// Moves a snapshot forward by one entry; false if it doesn't fit the shoe
+bool applyJournalEntry(const JournalEntry& entry, TableSnapshot& snapshot);
+
+#endif // SAVEGAME_H
@@ -0,0 +1,292 @@
+#include "session.h"
+#include "savegame.h"
+#include <cstring>
+
+SessionRecorder::SessionRecorder()
+{
+    bytes.reserve(4096);
+    bytes.insert(bytes.end(), {'B', 'J', 'R', 'S', VERSION});
+}
+
+void SessionRecorder::op(Op code)
+{
+    bytes.push_back(static_cast<std::uint8_t>(code));
+}
+
+void SessionRecorder::putVarint(std::uint64_t v)
+{
+    while (v >= 0x80) {
+        bytes.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    bytes.push_back(static_cast<std::uint8_t>(v));
+}
+
+void SessionRecorder::putSigned(long long v)
+{
+    // zigzag so small negative numbers stay small
+    putVarint((static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+void SessionRecorder::seed(std::uint64_t seed, std::uint64_t stream)
+{
+    op(Op::Seed);
+    putVarint(seed);
+    putVarint(stream);
+}
+
+void SessionRecorder::setRules(const Rules& rules)
+{
+    // keep in step with Rules (and with the decoder below)
+    std::uint64_t penetration;
+    std::memcpy(&penetration, &rules.penetration, sizeof(penetration));
+
+    op(Op::SetRules);
+    putVarint(static_cast<std::uint64_t>(rules.numDecks));
+    putVarint(penetration);
+    putVarint(static_cast<std::uint64_t>(rules.dealerTarget));
+    putVarint(static_cast<std::uint64_t>(rules.blackjackPayNum));
+    putVarint(static_cast<std::uint64_t>(rules.blackjackPayDen));
+    putVarint((rules.allowDouble ? 1u : 0u) | (rules.allowSurrender ? 2u : 0u) | (rules.continuousShuffle ? 4u : 0u));
+    putVarint(static_cast<std::uint64_t>(rules.maxHands));
+    putVarint((rules.allowSplit ? 1u : 0u) | (rules.doubleAfterSplit ? 2u : 0u)
+              | (rules.resplitAces ? 4u : 0u) | (rules.hitSplitAces ? 8u : 0u));
+}
+
+void SessionRecorder::setBalance(long long amount)
+{
+    op(Op::SetBalance);
+    putSigned(amount);
+}
+
+void SessionRecorder::shuffle() { op(Op::Shuffle); }
+
+void SessionRecorder::bet(int amount)
+{
+    op(Op::Bet);
+    putSigned(amount);
+}
+
+void SessionRecorder::deal() { op(Op::Deal); }
+void SessionRecorder::hit() { op(Op::Hit); }
+void SessionRecorder::doubleDown() { op(Op::Double); }
+void SessionRecorder::split() { op(Op::Split); }
+void SessionRecorder::standHand() { op(Op::StandHand); }
+void SessionRecorder::revealHole() { op(Op::RevealHole); }
+void SessionRecorder::dealerDraw() { op(Op::DealerDraw); }
+
+void SessionRecorder::endRound(bool playerBust, bool dealerBust, const RoundResult& result, long long balance)
+{
+    op(Op::EndRound);
+    putVarint((playerBust ? 1u : 0u) | (dealerBust ? 2u : 0u));
+    putVarint(static_cast<std::uint64_t>(result.outcome));
+    putSigned(balance);
+}
+
+void SessionRecorder::surrender(long long balance)
+{
+    op(Op::Surrender);
+    putSigned(balance);
+}
+
+void SessionRecorder::restore(const TableSnapshot& snapshot)
+{
+    SaveGame save;
+    save.table = snapshot;
+    const std::vector<std::uint8_t> encoded = encodeSave(save);
+
+    op(Op::Restore);
+    putVarint(encoded.size());
+    bytes.insert(bytes.end(), encoded.begin(), encoded.end());
+}
+
+void SessionRecorder::takeBytes(std::vector<std::uint8_t>& out)
+{
+    out.insert(out.end(), bytes.begin(), bytes.end());
+    bytes.clear();
+}
+
+// ---------------- Replay ----------------
+
+namespace {
+
+class Reader
+{
+public:
+    Reader(const std::uint8_t* data, std::size_t size) : p(data), end(data + size) {}
+
+    bool atEnd() const { return p == end; }
+    bool failed() const { return bad; }
+
+    std::uint8_t byte()
+    {
+        if (p == end) { bad = true; return 0; }
+        return *p++;
+    }
+
+    std::uint64_t varint()
+    {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t b = byte();
+            v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        bad = true;
+        return 0;
+    }
+
+    long long signedVarint()
+    {
+        const std::uint64_t v = varint();
+        return static_cast<long long>((v >> 1) ^ (~(v & 1) + 1));
+    }
+
+    const std::uint8_t* take(std::size_t n)
+    {
+        if (static_cast<std::size_t>(end - p) < n) { bad = true; return nullptr; }
+        const std::uint8_t* at = p;
+        p += n;
+        return at;
+    }
+
+private:
+    const std::uint8_t* p;
+    const std::uint8_t* end;
+    bool bad = false;
+};
+
+} // namespace
+
+ReplayResult replaySession(const std::uint8_t* data, std::size_t size)
+{
+    using Op = SessionRecorder::Op;
+
+    ReplayResult result;
+    if (size < 5 || std::memcmp(data, "BJRS", 4) != 0) {
+        result.error = "not a session file";
+        return result;
+    }
+    const std::uint8_t version = data[4];
+    if (version < 1 || version > SessionRecorder::VERSION) {
+        result.error = "unsupported session version";
+        return result;
+    }
+
+    Table table;
+    Reader in(data + 5, size - 5);
+
+    auto fail = [&](const std::string& why) {
+        result.error = why;
+        result.failedAtRound = result.rounds;
+        result.finalBalance = table.balance();
+        return result;
+    };
+
+    while (!in.atEnd()) {
+        const Op code = static_cast<Op>(in.byte());
+        ++result.ops;
+
+        switch (code) {
+        case Op::Seed: {
+            const std::uint64_t seed = in.varint();
+            const std::uint64_t stream = in.varint();
+            table.seed(seed, stream);
+            break;
+        }
+        case Op::SetRules: {
+            Rules rules;
+            rules.numDecks = static_cast<int>(in.varint());
+            const std::uint64_t penetration = in.varint();
+            std::memcpy(&rules.penetration, &penetration, sizeof(penetration));
+            rules.dealerTarget = static_cast<int>(in.varint());
+            rules.blackjackPayNum = static_cast<int>(in.varint());
+            rules.blackjackPayDen = static_cast<int>(in.varint());
+            const std::uint64_t flags = in.varint();
+            rules.allowDouble = flags & 1;
+            rules.allowSurrender = flags & 2;
+            rules.continuousShuffle = flags & 4;
+            if (version >= 2) {
+                rules.maxHands = static_cast<int>(in.varint());
+                const std::uint64_t split = in.varint();
+                rules.allowSplit = split & 1;
+                rules.doubleAfterSplit = split & 2;
+                rules.resplitAces = split & 4;
+                rules.hitSplitAces = split & 8;
+            }
+            if (rules.numDecks < 1 || rules.blackjackPayDen < 1) return fail("bad rules");
+            table.setRules(rules);
+            break;
+        }
+        case Op::SetBalance:
+            table.setBalance(in.signedVarint());
+            break;
+        case Op::Shuffle:
+            table.shuffle();
+            break;
+        case Op::Bet: {
+            const long long amount = in.signedVarint();
+            if (in.failed()) return fail("session is truncated");
+            if (!table.placeBet(static_cast<int>(amount))) return fail("bet refused");
+            break;
+        }
+        case Op::Deal:
+            table.dealInitialCards();
+            break;
+        case Op::Hit:
+            table.hit();
+            break;
+        case Op::Double:
+            if (!table.doubleDown()) return fail("double refused");
+            break;
+        case Op::Split:
+            if (!table.split()) return fail("split refused");
+            break;
+        case Op::StandHand:
+            table.standHand();
+            break;
+        case Op::RevealHole:
+            table.revealHoleCard();
+            break;
+        case Op::DealerDraw:
+            table.dealerDraw();
+            break;
+        case Op::EndRound: {
+            in.varint(); // bust flags, the table works them out from the cards
+            const std::uint64_t outcome = in.varint();
+            const long long balance = in.signedVarint();
+            if (in.failed()) return fail("session is truncated");
+            const RoundResult r = table.endRound();
+            result.stats.add(r);
+            if (static_cast<std::uint64_t>(r.outcome) != outcome) return fail("round outcome differs");
+            if (table.balance() != balance) return fail("balance differs");
+            ++result.rounds;
+            break;
+        }
+        case Op::Surrender: {
+            const long long balance = in.signedVarint();
+            if (in.failed()) return fail("session is truncated");
+            result.stats.add(table.surrender());
+            if (table.balance() != balance) return fail("balance differs");
+            ++result.rounds;
+            break;
+        }
+        case Op::Restore: {
+            const std::size_t length = static_cast<std::size_t>(in.varint());
+            const std::uint8_t* encoded = in.take(length);
+            SaveGame save;
+            if (!encoded || decodeSave(encoded, length, save) != SaveError::None) return fail("bad restore record");
+            table.restore(save.table);
+            break;
+        }
+        default:
+            return fail("unknown op");
+        }
+
+        if (in.failed()) return fail("session is truncated");
+    }
+
+    result.ok = true;
+    result.finalBalance = table.balance();
+    return result;
+}
@@ -0,0 +1,93 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "table.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Recorded play session.
+//
+// A Table with a SessionRecorder attached writes one small op for every
+// call that changes it: seed, rules, balance, shuffles, bets, player
+// actions, dealer draws and the settlement of each round (with the balance
+// it came to). Since the table's RNG is seeded explicitly, everything
+// else - which cards come out - follows from the ops, so replaying them
+// on a fresh Table reproduces the session exactly and the recorded
+// balances can be checked round by round.
+//
+//   "BJRS" version(1 byte), then ops: opcode byte + varint arguments
+
+class SessionRecorder
+{
+public:
+    enum class Op : std::uint8_t {
+        Seed = 1,       // seed, stream
+        SetRules,       // Rules fields
+        SetBalance,     // amount
+        Shuffle,
+        Bet,            // amount
+        Deal,
+        Hit,
+        Double,
+        RevealHole,
+        DealerDraw,
+        EndRound,       // allHandsBust | dealerBust << 1, outcome of the first hand, balance after
+        Surrender,      // balance after
+        Restore,        // length + encoded SaveGame (save/load, autosave resume)
+        Split,
+        StandHand
+    };
+
+    // 2 added splitting (Split, StandHand, split rules in SetRules); 1 still replays
+    static constexpr std::uint8_t VERSION = 2;
+
+    SessionRecorder();
+
+    // called by Table
+    void seed(std::uint64_t seed, std::uint64_t stream);
+    void setRules(const Rules& rules);
+    void setBalance(long long amount);
+    void shuffle();
+    void bet(int amount);
+    void deal();
+    void hit();
+    void doubleDown();
+    void split();
+    void standHand();
+    void revealHole();
+    void dealerDraw();
+    void endRound(bool playerBust, bool dealerBust, const RoundResult& result, long long balance);
+    void surrender(long long balance);
+    void restore(const TableSnapshot& snapshot);
+
+    // hands over everything recorded since the last call (for appending
+    // to the session file); the first call includes the file header
+    void takeBytes(std::vector<std::uint8_t>& out);
+
+    std::size_t pendingBytes() const { return bytes.size(); }
+
+private:
+    void op(Op code);
+    void putVarint(std::uint64_t v);
+    void putSigned(long long v);
+
+    std::vector<std::uint8_t> bytes;
+};
+
+struct ReplayResult {
+    bool ok = false;
+    std::string error;           // first divergence or decoding problem
+    long long ops = 0;
+    long long rounds = 0;
+    long long failedAtRound = -1;
+    long long finalBalance = 0;
+    RoundStats stats;
+};
+
+// Re-executes a recorded session on a fresh Table and checks every
+// settlement against the recording.
+ReplayResult replaySession(const std::uint8_t* data, std::size_t size);
+
+#endif // SESSION_H
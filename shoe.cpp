@@ -0,0 +1,102 @@
+#include "shoe.h"
+#include <algorithm>
+
+Shoe::Shoe(int numDecks, double penetration)
+    : decks(numDecks > 0 ? numDecks : 1)
+{
+    setPenetration(penetration);
+}
+
+void Shoe::setNumDecks(int numDecks)
+{
+    decks = numDecks > 0 ? numDecks : 1;
+    placeCutCard();
+}
+
+void Shoe::setPenetration(double fraction)
+{
+    pen = std::clamp(fraction, 0.05, 1.0);
+    placeCutCard();
+}
+
+void Shoe::placeCutCard()
+{
+    // cards already dealt from the full shoe count towards the cut
+    const int dealt = size() - static_cast<int>(cards.size()) + next;
+    cutCard = std::max(0, static_cast<int>(size() * pen) - dealt + next);
+}
+
+void Shoe::fill(std::vector<Card>& cards, int decks, Rng& rng)
+{
+    // capacity is kept between shoes, so after the first one this only
+    // rewrites bytes
+    cards.resize(static_cast<std::size_t>(decks) * 52);
+
+    auto out = cards.begin();
+    for (int j = 0; j < decks; j++) {
+        for (int s = Card::Hearts; s <= Card::Spades; s++) {
+            for (int r = 1; r <= 13; r++) {
+                *out++ = Card::make(r, static_cast<Card::Suit>(s));
+            }
+        }
+    }
+
+    std::shuffle(cards.begin(), cards.end(), rng);
+}
+
+void Shoe::shuffle(Rng& rng)
+{
+    fill(cards, decks, rng);
+    rewind();
+}
+
+void Shoe::swapIn(std::vector<Card>& shuffled)
+{
+    cards.swap(shuffled);
+    rewind();
+}
+
+void Shoe::rewind()
+{
+    next = 0;
+    ++gen;
+    placeCutCard();
+
+    left.fill(0);
+    for (int r = 1; r <= 13; ++r) left[r] = static_cast<std::uint16_t>(4 * decks);
+    running = system->startingCount(decks);
+}
+
+void Shoe::setCountSystem(CountSystemId id)
+{
+    systemId = id;
+    system = &::countSystem(id);
+    recount();
+}
+
+void Shoe::recount()
+{
+    left.fill(0);
+    for (int i = next; i < static_cast<int>(cards.size()); ++i) {
+        ++left[cards[i].rank()];
+    }
+    // whatever isn't left of a full shoe has been dealt
+    running = system->startingCount(decks);
+    for (int r = 1; r <= 13; ++r) {
+        running += system->tag[r] * (4 * decks - left[r]);
+    }
+}
+
+std::vector<Card> Shoe::contents() const
+{
+    return std::vector<Card>(cards.begin() + next, cards.end());
+}
+
+void Shoe::setContents(const std::vector<Card>& newCards)
+{
+    cards = newCards;
+    next = 0;
+    ++gen;
+    placeCutCard();
+    recount();
+}
@@ -0,0 +1,116 @@
+#ifndef SHOE_H
+#define SHOE_H
+
+#include "card.h"
+#include "countsystem.h"
+#include "rng.h"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// The shoe: numDecks standard decks shuffled together, stored as a flat
+// byte array of packed cards (an 8 deck shoe is 416 bytes).
+// Drawing just moves a cursor forward. Once the cursor passes the cut
+// card the shoe asks for a reshuffle, which the table does between
+// rounds instead of in the middle of a hand.
+//
+// The shoe also keeps how many of each rank are left and the running
+// count for one counting system, both updated as cards are drawn, so
+// the composition, running count and true count cost nothing to ask for.
+class Shoe
+{
+public:
+    explicit Shoe(int numDecks = 1, double penetration = 1.0);
+
+    void setNumDecks(int decks);
+    int numDecks() const { return decks; }
+
+    // fraction of the shoe dealt before the cut card comes out (0..1]
+    void setPenetration(double fraction);
+    double penetration() const { return pen; }
+
+    // rebuild all numDecks*52 cards, shuffle them and rewind the cursor
+    void shuffle(Rng& rng);
+
+    // what shuffle() does to the cards, for building a shoe elsewhere
+    // (see ShuffleWorker); the same rng state gives the same shoe
+    static void fill(std::vector<Card>& cards, int decks, Rng& rng);
+
+    // swap in a full shoe made by fill() with numDecks decks, as if it
+    // had just been shuffled; shuffled gets the old cards back
+    void swapIn(std::vector<Card>& shuffled);
+
+    Card draw()
+    {
+        const Card c = cards[next++];
+        --left[c.rank()];
+        running += system->tag[c.rank()];
+        return c;
+    }
+    bool empty() const { return next >= static_cast<int>(cards.size()); }
+    int remaining() const { return static_cast<int>(cards.size()) - next; }
+    int size() const { return decks * 52; }
+    bool pastCutCard() const { return next >= cutCard; }
+
+    // Continuous shuffling machine: drawRandom() takes a uniformly random
+    // card from what's left (swapped to the cursor, one step of a lazy
+    // Fisher-Yates) and putBack() returns a card to the undealt part in
+    // one write. Together the shoe never needs reshuffling as a whole.
+    Card drawRandom(Rng& rng)
+    {
+        const int pick = next + static_cast<int>(rng.below(static_cast<std::uint32_t>(remaining())));
+        std::swap(cards[next], cards[pick]);
+        return draw();
+    }
+    void putBack(Card c)
+    {
+        // the slot in front of the cursor held a card already dealt
+        if (next > 0) cards[--next] = c;
+        else cards.push_back(c); // only after loading a save mid-round
+        ++left[c.rank()];
+        running -= system->tag[c.rank()];
+    }
+
+    // cards of this rank (1 = ace ... 13 = king) still to be dealt
+    int remainingOfRank(int rank) const { return left[rank]; }
+    // tens, jacks, queens and kings together
+    int remainingTens() const { return left[10] + left[11] + left[12] + left[13]; }
+
+    // counting system for runningCount(); switching recounts what's been dealt
+    void setCountSystem(CountSystemId id);
+    CountSystemId countSystemId() const { return systemId; }
+    const CountSystem& countSystem() const { return *system; }
+
+    // over every card dealt since the shuffle
+    int runningCount() const { return running; }
+    // running count per deck left in the shoe
+    double trueCount() const { return remaining() > 0 ? running * 52.0 / remaining() : 0.0; }
+
+    // bumped whenever the cards are replaced (shuffle, load), so a
+    // watcher can tell "more cards dealt" from "different shoe"
+    unsigned generation() const { return gen; }
+
+    // used by save/load: only the cards still to be dealt
+    std::vector<Card> contents() const;
+    void setContents(const std::vector<Card>& newCards);
+
+private:
+    void placeCutCard();
+    void recount(); // left and running from the cards still in the shoe
+    void rewind();  // cursor, cut card and counts for a fresh full shoe
+
+    int decks = 1;
+    double pen = 1.0;
+    std::vector<Card> cards;
+    int next = 0;    // index of the next card to deal
+    int cutCard = 0; // reshuffle once next reaches this
+    unsigned gen = 0;
+
+    std::array<std::uint16_t, 16> left{}; // by rank
+    int running = 0;
+    CountSystemId systemId = CountSystemId::HiLo;
+    const CountSystem* system = &::countSystem(CountSystemId::HiLo);
+};
+
+#endif // SHOE_H
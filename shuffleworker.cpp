@@ -0,0 +1,70 @@
+#include "shuffleworker.h"
+#include "shoe.h"
+#include "trace.h"
+#include <utility>
+
+ShuffleWorker::ShuffleWorker()
+    : thread(&ShuffleWorker::workerLoop, this)
+{
+}
+
+ShuffleWorker::~ShuffleWorker()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void ShuffleWorker::waitIdle(std::unique_lock<std::mutex>& guard)
+{
+    // only when the table got to the cut card before the worker finished
+    done.wait(guard, [&] { return !requested && !working; });
+}
+
+void ShuffleWorker::prepare(int decks, const Rng& rng)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    waitIdle(guard);
+    ready.store(false, std::memory_order_relaxed);
+    jobDecks = decks;
+    jobRng = rng;
+    requested = true;
+    wake.notify_one();
+}
+
+bool ShuffleWorker::take(int decks, std::vector<Card>& cards, Rng& rng)
+{
+    // pairs with the release in workerLoop: buffer and jobRng are complete
+    if (!ready.load(std::memory_order_acquire) || jobDecks != decks) return false;
+    ready.store(false, std::memory_order_relaxed);
+    cards.swap(buffer);
+    rng = jobRng;
+    return true;
+}
+
+void ShuffleWorker::workerLoop()
+{
+    Trace::nameThread("Shuffle worker");
+
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;) {
+        wake.wait(guard, [&] { return stopping || requested; });
+        if (stopping) return;
+        requested = false;
+        working = true;
+
+        guard.unlock();
+        {
+            TRACE_SCOPE("ShuffleWorker::shuffle", "shoe");
+            Shoe::fill(buffer, jobDecks, jobRng);
+        }
+        ready.store(true, std::memory_order_release);
+        guard.lock();
+
+        working = false;
+        done.notify_all();
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef SHUFFLEWORKER_H
+#define SHUFFLEWORKER_H
+
+#include "card.h"
+#include "rng.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Shuffles the next shoe on its own thread while the current one is
+// being dealt. The table asks for the next shoe with a copy of its Rng;
+// since the Rng is only used for shuffling, the shoe that comes back is
+// exactly the one a shuffle at the cut card would have made, so recorded
+// sessions replay the same with or without the worker.
+//
+// Handing the shoe over is one acquire load and a vector swap. If the
+// worker isn't done yet (or was asked for a different deck count) take()
+// returns false and the table shuffles in place as before.
+class ShuffleWorker
+{
+public:
+    ShuffleWorker();
+    ~ShuffleWorker();
+
+    ShuffleWorker(const ShuffleWorker&) = delete;
+    ShuffleWorker& operator=(const ShuffleWorker&) = delete;
+
+    // start on the shoe after this one; rng is where the table's Rng is
+    // now. Drops whatever was prepared before.
+    void prepare(int decks, const Rng& rng);
+
+    // if the shoe for decks is ready: swaps it into cards (the old cards
+    // become the worker's buffer) and moves rng past the shuffle
+    bool take(int decks, std::vector<Card>& cards, Rng& rng);
+
+private:
+    void workerLoop();
+    void waitIdle(std::unique_lock<std::mutex>& guard);
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool requested = false;
+    bool working = false;
+    bool stopping = false;
+
+    // owned by the worker from prepare() until ready is set, by the
+    // table from then until the next prepare()
+    int jobDecks = 0;
+    Rng jobRng;
+    std::vector<Card> buffer;
+    std::atomic<bool> ready{false};
+
+    std::thread thread;
+};
+
+#endif // SHUFFLEWORKER_H
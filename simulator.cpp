@@ -0,0 +1,19 @@
+#include "simulator.h"
+#include <algorithm>
+#include <cmath>
+
+int SimulationConfig::betFor(const Table& table) const
+{
+    // a reshuffle is coming, the count is about to start over
+    if (table.shoe().pastCutCard()) return bet;
+    const int units = static_cast<int>(std::floor(table.trueCount()));
+    return bet * std::clamp(units, 1, spread);
+}
+
+double SimulationResult::standardError() const
+{
+    if (stats.rounds < 2 || stats.wagered == 0) return 0.0;
+    // edge = -net/wagered, so scale the per-round error by the average bet
+    const double averageBet = static_cast<double>(stats.wagered) / stats.rounds;
+    return std::sqrt(stats.variancePerRound() / stats.rounds) / averageBet;
+}
@@ -0,0 +1,86 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include "ruleset.h"
+#include "table.h"
+#include "workstealingpool.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Monte Carlo driver: splits a run into fixed size chunks and plays them
+// on a WorkStealingPool. Every chunk gets its own Table seeded with
+// (seed, chunk index), so a given seed gives the same totals no matter how
+// many threads ran it or which thread picked up which chunk.
+
+struct SimulationConfig {
+    Rules rules;
+    std::int64_t rounds = 10000000;
+    std::int64_t chunkRounds = 1 << 18;
+    int threads = 0;         // 0 = all hardware threads
+    std::uint64_t seed = 1;
+    int bet = 10;            // a multiple of 10 so 3:2, 6:5 and surrender pay exactly
+
+    // bet spread off the count: 1 is flat betting, otherwise each round
+    // bets bet * clamp(floor(true count), 1, spread) in countSystem
+    int spread = 1;
+    CountSystemId countSystem = CountSystemId::HiLo;
+
+    int betFor(const Table& table) const;
+};
+
+struct SimulationResult {
+    RoundStats stats;
+    int threads = 1;
+    double seconds = 0.0;
+
+    double houseEdge() const { return stats.houseEdge(); }
+    double standardError() const;   // of the house edge
+    double confidence95() const { return 1.96 * standardError(); }
+    double roundsPerSecond() const { return seconds > 0 ? stats.rounds / seconds : 0.0; }
+};
+
+// The run with every round played under RuleSet (DynamicRuleSet, or
+// one matching config.rules)
+template <typename RuleSet, typename Policy>
+SimulationResult runSimulationWith(const SimulationConfig& config, const Policy& policy)
+{
+    const std::int64_t chunk = config.chunkRounds > 0 ? config.chunkRounds : 1;
+    const std::int64_t numChunks = (config.rounds + chunk - 1) / chunk;
+    std::vector<RoundStats> partial(static_cast<size_t>(numChunks));
+
+    WorkStealingPool pool(config.threads);
+    const auto start = std::chrono::steady_clock::now();
+
+    pool.run(numChunks, [&](std::int64_t task, int) {
+        Table table(config.rules);
+        table.setCountSystem(config.countSystem);
+        table.seed(config.seed, static_cast<std::uint64_t>(task));
+        const std::int64_t n = std::min(chunk, config.rounds - task * chunk);
+        if (config.spread > 1) {
+            partial[task] = table.playRounds<RuleSet>(n, policy, [&config](const Table& t) { return config.betFor(t); });
+        } else {
+            partial[task] = table.playRounds<RuleSet>(n, policy, config.bet);
+        }
+    });
+
+    SimulationResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.threads = pool.threadCount();
+    for (const RoundStats& s : partial) {
+        result.stats.merge(s); // merged in chunk order so the sum is reproducible
+    }
+    return result;
+}
+
+// Picks the round loop specialized for config.rules at run time (see
+// withRuleSet); totals are the same as with DynamicRuleSet.
+template <typename Policy>
+SimulationResult runSimulation(const SimulationConfig& config, const Policy& policy)
+{
+    return withRuleSet(config.rules, [&](auto ruleSet) {
+        return runSimulationWith<decltype(ruleSet)>(config, policy);
+    });
+}
+
+#endif // SIMULATOR_H
@@ -0,0 +1,88 @@
+#include "strategy.h"
+
+namespace {
+
+// Columns are dealer upcards 2,3,4,5,6,7,8,9,10,A
+// H = hit, S = stand, D = double else hit, d = double else stand,
+// R = surrender else hit
+const char* const hardTable[] = {
+    /* 4-8 */ "HHHHHHHHHH",
+    /*  9  */ "HDDDDHHHHH",
+    /* 10  */ "DDDDDDDDHH",
+    /* 11  */ "DDDDDDDDDH",
+    /* 12  */ "HHSSSHHHHH",
+    /* 13  */ "SSSSSHHHHH",
+    /* 14  */ "SSSSSHHHHH",
+    /* 15  */ "SSSSSHHHRH",
+    /* 16  */ "SSSSSHHRRR",
+    /* 17+ */ "SSSSSSSSSS",
+};
+
+const char* const softTable[] = {
+    /* A,A */ "HHHHHHHHHH",
+    /* A,2 */ "HHHDDHHHHH",
+    /* A,3 */ "HHHDDHHHHH",
+    /* A,4 */ "HHDDDHHHHH",
+    /* A,5 */ "HHDDDHHHHH",
+    /* A,6 */ "HDDDDHHHHH",
+    /* A,7 */ "SddddSSHHH",
+    /* A,8+ */"SSSSSSSSSS",
+};
+
+// P = split, anything else = play the total
+const char* const pairTable[] = {
+    /* A,A */ "PPPPPPPPPP",
+    /* 2,2 */ "PPPPPPHHHH",
+    /* 3,3 */ "PPPPPPHHHH",
+    /* 4,4 */ "HHHPPHHHHH",
+    /* 5,5 */ "HHHHHHHHHH",
+    /* 6,6 */ "PPPPPHHHHH",
+    /* 7,7 */ "PPPPPPHHHH",
+    /* 8,8 */ "PPPPPPPPPP",
+    /* 9,9 */ "PPPPPSPPSS",
+    /* T,T */ "SSSSSSSSSS",
+};
+
+} // namespace
+
+Action BasicStrategyPolicy::decide(int total, bool soft, int upcard, bool firstAction)
+{
+    const int col = upcard - 2;
+    char move;
+
+    if (soft) {
+        const int row = total <= 12 ? 0 : (total >= 19 ? 7 : total - 12);
+        move = softTable[row][col];
+    } else {
+        int row;
+        if (total <= 8) row = 0;
+        else if (total >= 17) row = 9;
+        else row = total - 8;
+        move = hardTable[row][col];
+    }
+
+    switch (move) {
+    case 'S': return Action::Stand;
+    case 'D': return firstAction ? Action::Double : Action::Hit;
+    case 'd': return firstAction ? Action::Double : Action::Stand;
+    case 'R': return firstAction ? Action::Surrender : Action::Hit;
+    default:  return Action::Hit;
+    }
+}
+
+bool BasicStrategyPolicy::shouldSplit(int pairRank, int upcard)
+{
+    const int row = pairRank >= 10 ? 9 : pairRank - 1;
+    return pairTable[row][upcard - 2] == 'P';
+}
+
+Action BasicStrategyPolicy::operator()(const Table& t) const
+{
+    const Hand& hand = t.playerHand();
+    const int upcard = t.dealerHand().front().value();
+    if (t.canSplit() && shouldSplit(hand[0].rank(), upcard)) {
+        return Action::Split;
+    }
+    const bool firstAction = hand.size() == 2;
+    return decide(hand.value(), hand.isSoft(), upcard, firstAction);
+}
@@ -0,0 +1,18 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include "table.h"
+
+// Textbook multi-deck basic strategy (dealer stands on 17, late
+// surrender, double after split). Pairs that shouldn't be split, or can't
+// be right now, are played as their total.
+struct BasicStrategyPolicy {
+    Action operator()(const Table& t) const;
+
+    // lookup without a table: upcard is 2..11 (11 = ace)
+    static Action decide(int total, bool soft, int upcard, bool firstAction);
+    // pairRank is the rank of either card (1 = ace, 10 for any ten)
+    static bool shouldSplit(int pairRank, int upcard);
+};
+
+#endif // STRATEGY_H
@@ -0,0 +1,127 @@
+#include "strategyadvisor.h"
+#include "strategytablefile.h"
+#include "trace.h"
+
+// ---------------- AdvisorWorker (advisor thread) ----------------
+
+AdvisorWorker::AdvisorWorker(const std::atomic<quint64>& latestRequest)
+    : latest(latestRequest)
+{
+}
+
+const StrategyTable& AdvisorWorker::tableFor(const Rules& rules)
+{
+    for (const StrategyTable& t : tables) {
+        if (StrategyTable::sameNumbers(t.rules(), rules)) return t;
+    }
+    // blackjack_tablegen's file has the usual rule sets; anything else is
+    // built here, up to a second for eight decks
+    StrategyTable mapped = StrategyTableFile::shared().find(rules);
+    tables.push_back(mapped.isBuilt() ? mapped : StrategyTable::build(rules));
+    return tables.back();
+}
+
+void AdvisorWorker::prepare(const Rules& rules)
+{
+    Trace::nameThread("StrategyAdvisor");
+    TRACE_SCOPE("strategy table", "worker");
+    tableFor(rules);
+}
+
+void AdvisorWorker::compute(const AdviceRequest& request)
+{
+    if (stale(request.id)) return;
+
+    // quick answer from the table
+    Advice advice;
+    advice.request = request.id;
+    {
+        TRACE_SCOPE("advice lookup", "worker");
+        const StrategyTable& table = tableFor(request.rules);
+        advice.ev = table.lookup(request.player, request.upcard, request.firstAction, request.splitHand);
+        advice.dealerBust = table.dealer(ShoeComposition::indexOf(request.upcard)).bust;
+        advice.ev.canDouble = advice.ev.canDouble && request.canDouble;
+        emit adviceReady(advice);
+    }
+
+    if (stale(request.id)) return;
+
+    // exact answer for this shoe, given up as soon as a newer request arrives
+    if (solver.rules() != request.rules) {
+        solver.setRules(request.rules);
+    }
+    TRACE_SCOPE("advice exact EV", "worker");
+    const quint64 id = request.id;
+    solver.setCancelCheck([this, id] { return stale(id); });
+
+    ActionEV exact = solver.evaluate(request.player, request.upcard, request.unseen, request.firstAction,
+                                     request.splitHand);
+    if (solver.wasCancelled() || stale(id)) return;
+
+    advice.ev = exact;
+    advice.ev.canDouble = advice.ev.canDouble && request.canDouble;
+    advice.exact = true;
+    emit adviceReady(advice);
+}
+
+// ---------------- StrategyAdvisor (GUI thread) ----------------
+
+StrategyAdvisor::StrategyAdvisor(QObject *parent)
+    : QObject(parent)
+    , worker(new AdvisorWorker(latest))
+{
+    qRegisterMetaType<Advice>();
+
+    worker->moveToThread(&workerThread);
+    connect(&workerThread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(worker, &AdvisorWorker::adviceReady, this, &StrategyAdvisor::onWorkerAdvice);
+    workerThread.setObjectName("StrategyAdvisor");
+    workerThread.start(QThread::LowPriority);
+}
+
+StrategyAdvisor::~StrategyAdvisor()
+{
+    cancel();
+    workerThread.quit();
+    workerThread.wait();
+}
+
+void StrategyAdvisor::prepare(const Rules& rules)
+{
+    AdvisorWorker* w = worker;
+    QMetaObject::invokeMethod(worker, [w, rules] { w->prepare(rules); }, Qt::QueuedConnection);
+}
+
+void StrategyAdvisor::request(const Table& table)
+{
+    if (!table.inProgress() || table.dealerHand().empty()) {
+        cancel();
+        return;
+    }
+
+    AdviceRequest req;
+    req.id = ++latest;
+    req.rules = table.rules();
+    req.player = table.playerHand();
+    req.upcard = table.dealerHand().front();
+    req.unseen = unseenComposition(table);
+    req.firstAction = table.canSurrender();
+    req.canDouble = table.canDouble();
+    req.splitHand = table.handCount() > 1;
+
+    AdvisorWorker* w = worker;
+    QMetaObject::invokeMethod(worker, [w, req] { w->compute(req); }, Qt::QueuedConnection);
+}
+
+void StrategyAdvisor::cancel()
+{
+    ++latest;
+}
+
+void StrategyAdvisor::onWorkerAdvice(const Advice& advice)
+{
+    // the worker may finish just after a newer request went out
+    if (advice.request == latest.load()) {
+        emit adviceReady(advice);
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef STRATEGYADVISOR_H
+#define STRATEGYADVISOR_H
+
+#include <QObject>
+#include <QThread>
+#include <QMetaType>
+#include <atomic>
+#include <vector>
+#include "evsolver.h"
+#include "strategytable.h"
+
+// One piece of advice for the hand on the table
+struct Advice {
+    quint64 request = 0;
+    ActionEV ev;
+    bool exact = false;   // composition dependent, otherwise a basic strategy table lookup
+    double dealerBust = 0.0;   // from a full shoe, always the table's
+};
+Q_DECLARE_METATYPE(Advice)
+
+// Everything the worker needs, copied off the table on the GUI thread
+struct AdviceRequest {
+    quint64 id = 0;
+    Rules rules;
+    Hand player;
+    Card upcard;
+    ShoeComposition unseen;
+    bool firstAction = false;
+    bool canDouble = false;
+    bool splitHand = false;   // a two card 21 isn't a natural
+};
+
+// Lives on the advisor thread. Answers first from the precomputed table
+// for the deck count, then refines with EvSolver unless a newer request
+// has come in by then.
+class AdvisorWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AdvisorWorker(const std::atomic<quint64>& latestRequest);
+
+    void prepare(const Rules& rules);
+    void compute(const AdviceRequest& request);
+
+signals:
+    void adviceReady(const Advice& advice);
+
+private:
+    const StrategyTable& tableFor(const Rules& rules);
+    bool stale(quint64 id) const { return id != latest.load(std::memory_order_relaxed); }
+
+    const std::atomic<quint64>& latest;
+    std::vector<StrategyTable> tables;  // one per rule set seen (see StrategyTable::sameNumbers)
+    EvSolver solver;
+};
+
+// GUI side. request() never blocks: each call supersedes the previous one,
+// stale requests are skipped or abandoned mid-calculation, and only advice
+// for the newest request is passed on.
+class StrategyAdvisor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit StrategyAdvisor(QObject *parent = nullptr);
+    ~StrategyAdvisor();
+
+    void prepare(const Rules& rules);   // build the table ahead of the first hand
+    void request(const Table& table);
+    void cancel();
+
+signals:
+    void adviceReady(const Advice& advice);
+
+private slots:
+    void onWorkerAdvice(const Advice& advice);
+
+private:
+    QThread workerThread;
+    AdvisorWorker* worker;
+    std::atomic<quint64> latest{0};
+};
+
+#endif // STRATEGYADVISOR_H
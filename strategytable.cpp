@@ -0,0 +1,121 @@
+#include "strategytable.h"
+#include "strategy.h"
+
+namespace {
+
+Hand hardHand(int total)
+{
+    // two different non-ace cards where possible, hard 21 needs three
+    if (total == 21) return { Card::make(10, Card::Clubs), Card::make(9, Card::Clubs), Card::make(2, Card::Clubs) };
+    const int high = total - 2 > 10 ? 10 : total - 2;
+    return { Card::make(high, Card::Clubs), Card::make(total - high, Card::Hearts) };
+}
+
+Hand softHand(int total)
+{
+    if (total == 12) return { Card::make(1, Card::Clubs), Card::make(1, Card::Hearts) };
+    if (total == 21) return { Card::make(1, Card::Clubs), Card::make(5, Card::Hearts), Card::make(5, Card::Spades) };
+    return { Card::make(1, Card::Clubs), Card::make(total - 11, Card::Hearts) };
+}
+
+ShoeComposition fullShoe(int decks)
+{
+    ShoeComposition comp;
+    for (int i = 0; i < 9; ++i) comp.counts[i] = 4 * decks;
+    comp.counts[9] = 16 * decks;
+    comp.total = 52 * decks;
+    return comp;
+}
+
+} // namespace
+
+StrategyTable StrategyTable::build(const Rules& rules)
+{
+    auto data = std::make_shared<StrategyTableData>();
+
+    EvSolver solver(rules);
+    const ShoeComposition shoe = fullShoe(rules.numDecks);
+
+    auto solve = [&](const Hand& hand, int upcardIndex) {
+        const Card up = Card::make(upcardIndex == 0 ? 1 : upcardIndex + 1, Card::Diamonds);
+        ShoeComposition comp = shoe;
+        for (Card c : hand) comp.remove(c);
+        comp.remove(up);
+        return solver.evaluate(hand, up, comp, hand.size() == 2);
+    };
+
+    for (int up = 0; up < 10; ++up) {
+        for (int total = HARD_MIN; total <= 21; ++total) {
+            data->hardRows[total - HARD_MIN][up] = solve(hardHand(total), up);
+        }
+        for (int total = SOFT_MIN; total <= 21; ++total) {
+            data->softRows[total - SOFT_MIN][up] = solve(softHand(total), up);
+        }
+        data->naturalRow[up] = solve({ Card::make(1, Card::Clubs), Card::make(13, Card::Hearts) }, up);
+
+        ShoeComposition comp = shoe;
+        comp.remove(Card::make(up == 0 ? 1 : up + 1, Card::Diamonds));
+        data->dealerRow[up] = solver.dealerOutcome(comp, up);
+    }
+
+    StrategyTable table;
+    table.builtFor = rules;
+    table.rows = data.get();
+    table.owned = std::move(data);
+    return table;
+}
+
+StrategyTable StrategyTable::borrow(const Rules& rules, const StrategyTableData& data)
+{
+    StrategyTable table;
+    table.builtFor = rules;
+    table.rows = &data;
+    return table;
+}
+
+bool StrategyTable::sameNumbers(const Rules& a, const Rules& b)
+{
+    return a.numDecks == b.numDecks && a.dealerTarget == b.dealerTarget
+        && a.blackjackPayNum == b.blackjackPayNum && a.blackjackPayDen == b.blackjackPayDen
+        && a.allowDouble == b.allowDouble && a.allowSurrender == b.allowSurrender;
+}
+
+ActionEV StrategyTable::lookup(const Hand& player, Card upcard, bool firstAction, bool splitHand) const
+{
+    int hardSum = 0;
+    bool hasAce = false;
+    for (Card c : player) {
+        hardSum += c.isAce() ? 1 : c.value();
+        hasAce = hasAce || c.isAce();
+    }
+    const int up = ShoeComposition::indexOf(upcard);
+    const bool soft = hasAce && hardSum <= 11;
+    const int total = soft ? hardSum + 10 : hardSum;
+
+    ActionEV ev;
+    if (total > 21) {
+        ev.hit = ev.stand = ev.doubleDown = -1.0;
+    } else if (soft && total == 21 && player.size() == 2 && !splitHand) {
+        ev = rows->naturalRow[up];
+    } else if (soft) {
+        ev = rows->softRows[total - SOFT_MIN][up];
+    } else {
+        ev = rows->hardRows[(total < HARD_MIN ? HARD_MIN : total) - HARD_MIN][up];
+    }
+
+    ev.canSurrender = ev.canSurrender && firstAction;
+    return ev;
+}
+
+Action StrategyTablePolicy::operator()(const Table& t) const
+{
+    const Hand& hand = t.playerHand();
+    const Card upcard = t.dealerHand().front();
+    if (t.canSplit() && BasicStrategyPolicy::shouldSplit(hand[0].rank(), upcard.value())) {
+        return Action::Split;
+    }
+    ActionEV ev = table->lookup(hand, upcard, hand.size() == 2, t.handCount() > 1);
+    ev.canDouble = t.canDouble();
+    ev.canSurrender = t.canSurrender();
+    return ev.best();
+}
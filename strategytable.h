@@ -0,0 +1,74 @@
+#ifndef STRATEGYTABLE_H
+#define STRATEGYTABLE_H
+
+#include "evsolver.h"
+#include <array>
+#include <memory>
+#include <type_traits>
+
+// Everything in a strategy table, flat and pointer free so it can be
+// written to and read straight out of a mapped file (strategytablefile.h).
+struct StrategyTableData {
+    static constexpr int HARD_MIN = 4;   // rows 4..21
+    static constexpr int SOFT_MIN = 12;  // rows 12..21 (A,A .. A,X,X)
+
+    std::array<std::array<ActionEV, 10>, 21 - HARD_MIN + 1> hardRows;
+    std::array<std::array<ActionEV, 10>, 21 - SOFT_MIN + 1> softRows;
+    std::array<ActionEV, 10> naturalRow;
+    std::array<DealerOutcome, 10> dealerRow;   // full shoe less the upcard
+};
+static_assert(std::is_trivially_copyable<StrategyTableData>::value, "StrategyTableData is stored as raw bytes");
+
+// Basic strategy with numbers: the EV of every action for each hand
+// total against each upcard, worked out once from a full shoe with
+// EvSolver. Lookups are a couple of array reads, which is what the
+// advisor shows while the exact composition-dependent answer is still
+// being computed.
+//
+// The rows either belong to the table (build) or are borrowed from a
+// StrategyTableFile, which has to stay open while the table is in use.
+class StrategyTable
+{
+public:
+    static constexpr int HARD_MIN = StrategyTableData::HARD_MIN;
+    static constexpr int SOFT_MIN = StrategyTableData::SOFT_MIN;
+
+    StrategyTable() = default;
+
+    static StrategyTable build(const Rules& rules);
+    static StrategyTable borrow(const Rules& rules, const StrategyTableData& data);
+
+    // the rules a table's numbers depend on: deck count, dealer target,
+    // payout, double and surrender. Penetration, splits and CSM don't
+    // change them.
+    static bool sameNumbers(const Rules& a, const Rules& b);
+
+    bool isBuilt() const { return rows != nullptr; }
+    const Rules& rules() const { return builtFor; }
+    const StrategyTableData& data() const { return *rows; }
+
+    // a two card 21 on a split hand reads the soft 21 row, it isn't a natural
+    ActionEV lookup(const Hand& player, Card upcard, bool firstAction, bool splitHand = false) const;
+
+    // raw rows, upcard index as in ShoeComposition (0 = ace, 9 = ten)
+    const ActionEV& hard(int total, int upcardIndex) const { return rows->hardRows[total - HARD_MIN][upcardIndex]; }
+    const ActionEV& soft(int total, int upcardIndex) const { return rows->softRows[total - SOFT_MIN][upcardIndex]; }
+    const ActionEV& natural(int upcardIndex) const { return rows->naturalRow[upcardIndex]; }
+    const DealerOutcome& dealer(int upcardIndex) const { return rows->dealerRow[upcardIndex]; }
+
+private:
+    Rules builtFor;
+    std::shared_ptr<const StrategyTableData> owned;   // null when borrowed
+    const StrategyTableData* rows = nullptr;
+};
+
+// Plays the table's best action, so basic strategy worked out for the
+// table's own rules rather than the textbook chart. Pairs are split as
+// in BasicStrategyPolicy, the table has no pair rows.
+struct StrategyTablePolicy {
+    const StrategyTable* table = nullptr;
+
+    Action operator()(const Table& t) const;
+};
+
+#endif // STRATEGYTABLE_H
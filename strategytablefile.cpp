@@ -0,0 +1,183 @@
+#include "strategytablefile.h"
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[8] = { 'B', 'J', 'S', 'T', 'R', 'A', 'T', '\0' };
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// bump when StrategyTableData or the solver changes what goes in a table
+constexpr std::uint32_t FORMAT_VERSION = 1;
+
+// Maps the whole file read-only; the mapping outlives the file handle
+const void* mapFile(const std::string& path, std::size_t& bytes)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER size;
+    const void* view = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        bytes = static_cast<std::size_t>(size.QuadPart);
+    }
+    CloseHandle(file);
+    return view;
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    void* view = nullptr;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) view = nullptr;
+        bytes = static_cast<std::size_t>(st.st_size);
+    }
+    ::close(fd);
+    return view;
+#endif
+}
+
+void unmapFile(const void* view, std::size_t bytes)
+{
+#ifdef _WIN32
+    (void)bytes;
+    UnmapViewOfFile(view);
+#else
+    ::munmap(const_cast<void*>(view), bytes);
+#endif
+}
+
+} // namespace
+
+StrategyTableFile::~StrategyTableFile()
+{
+    close();
+}
+
+StrategyTableFile::Header StrategyTableFile::makeHeader(std::uint32_t count)
+{
+    Header h{};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = FORMAT_VERSION;
+    h.byteOrder = BYTE_ORDER_MARK;
+    h.entrySize = static_cast<std::uint32_t>(sizeof(Entry));
+    h.count = count;
+    return h;
+}
+
+bool StrategyTableFile::open(const std::string& path)
+{
+    close();
+
+    std::size_t bytes = 0;
+    const void* view = mapFile(path, bytes);
+    if (!view) return false;
+
+    Header h;
+    const Header expected = makeHeader(0);
+    if (bytes >= sizeof(Header)) std::memcpy(&h, view, sizeof(Header));
+    const bool valid = bytes >= sizeof(Header)
+        && !std::memcmp(h.magic, expected.magic, sizeof(h.magic))
+        && h.version == expected.version && h.byteOrder == expected.byteOrder
+        && h.entrySize == expected.entrySize
+        && bytes >= sizeof(Header) + std::size_t(h.count) * sizeof(Entry);
+    if (!valid) {
+        unmapFile(view, bytes);
+        return false;
+    }
+
+    mapping = view;
+    mappedBytes = bytes;
+    entries = reinterpret_cast<const Entry*>(static_cast<const char*>(view) + sizeof(Header));
+    count = h.count;
+    return true;
+}
+
+void StrategyTableFile::close()
+{
+    if (mapping) unmapFile(mapping, mappedBytes);
+    mapping = nullptr;
+    mappedBytes = 0;
+    entries = nullptr;
+    count = 0;
+}
+
+StrategyTable StrategyTableFile::find(const Rules& rules) const
+{
+    // a few dozen entries, a scan is as quick as anything
+    for (std::size_t i = 0; i < count; ++i) {
+        const Entry& e = entries[i];
+        if (e.numDecks == rules.numDecks && e.dealerTarget == rules.dealerTarget
+            && e.blackjackPayNum == rules.blackjackPayNum && e.blackjackPayDen == rules.blackjackPayDen
+            && (e.allowDouble != 0) == rules.allowDouble && (e.allowSurrender != 0) == rules.allowSurrender) {
+            return StrategyTable::borrow(rules, e.data);
+        }
+    }
+    return StrategyTable();
+}
+
+bool StrategyTableFile::write(const std::string& path, const std::vector<StrategyTable>& tables)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    const Header h = makeHeader(static_cast<std::uint32_t>(tables.size()));
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+    for (const StrategyTable& t : tables) {
+        Entry e{};
+        e.numDecks = t.rules().numDecks;
+        e.dealerTarget = t.rules().dealerTarget;
+        e.blackjackPayNum = t.rules().blackjackPayNum;
+        e.blackjackPayDen = t.rules().blackjackPayDen;
+        e.allowDouble = t.rules().allowDouble;
+        e.allowSurrender = t.rules().allowSurrender;
+        e.data = t.data();
+        out.write(reinterpret_cast<const char*>(&e), sizeof(e));
+    }
+    return static_cast<bool>(out);
+}
+
+std::vector<Rules> StrategyTableFile::standardRules()
+{
+    std::vector<Rules> out;
+    for (int decks : { 1, 2, 4, 6, 8 }) {
+        for (int target : { 17, 18 }) {
+            for (int payDen : { 2, 5 }) {
+                for (bool surrender : { true, false }) {
+                    Rules r;
+                    r.numDecks = decks;
+                    r.dealerTarget = target;
+                    r.blackjackPayNum = payDen == 2 ? 3 : 6;
+                    r.blackjackPayDen = payDen;
+                    r.allowSurrender = surrender;
+                    out.push_back(r);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+StrategyTableFile& StrategyTableFile::shared()
+{
+    static StrategyTableFile file;
+    return file;
+}
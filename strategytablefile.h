@@ -0,0 +1,81 @@
+#ifndef STRATEGYTABLEFILE_H
+#define STRATEGYTABLEFILE_H
+
+#include "strategytable.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Strategy tables for every rule set the game offers, built once by
+// blackjack_tablegen and mapped read-only at startup. Lookups then read
+// straight out of the mapping: no EvSolver run at launch, and every
+// process using the file shares the same pages.
+//
+// Layout: a Header, then Header::count Entries. The rows are stored as
+// the compiler lays out StrategyTableData, so the header records the
+// entry size and byte order, and a file from a different build (or a
+// different machine) is refused rather than misread.
+class StrategyTableFile
+{
+public:
+    static constexpr const char* DEFAULT_NAME = "strategy_tables.bin";
+
+    StrategyTableFile() = default;
+    ~StrategyTableFile();
+
+    StrategyTableFile(const StrategyTableFile&) = delete;
+    StrategyTableFile& operator=(const StrategyTableFile&) = delete;
+
+    // false if the file is missing, truncated or from another build
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return entries != nullptr; }
+    std::size_t size() const { return count; }
+
+    // a table borrowing the mapped rows, or one that isn't built if the
+    // file has nothing for these rules (see StrategyTable::sameNumbers)
+    StrategyTable find(const Rules& rules) const;
+
+    // writes tables in the format open() reads
+    static bool write(const std::string& path, const std::vector<StrategyTable>& tables);
+
+    // what blackjack_tablegen builds: 1/2/4/6/8 decks x dealer to 17/18 x
+    // 3:2/6:5 x surrender on/off
+    static std::vector<Rules> standardRules();
+
+    // The file the game and the simulator look in. Open it at startup,
+    // before other threads start looking.
+    static StrategyTableFile& shared();
+
+private:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t entrySize;
+        std::uint32_t count;
+        std::uint64_t reserved;   // keeps the entries 8 byte aligned
+    };
+
+    struct Entry {
+        std::int32_t numDecks;
+        std::int32_t dealerTarget;
+        std::int32_t blackjackPayNum;
+        std::int32_t blackjackPayDen;
+        std::uint8_t allowDouble;
+        std::uint8_t allowSurrender;
+        std::uint8_t padding[6];
+        StrategyTableData data;
+    };
+
+    static Header makeHeader(std::uint32_t count);
+
+    const void* mapping = nullptr;
+    std::size_t mappedBytes = 0;
+    const Entry* entries = nullptr;
+    std::size_t count = 0;
+};
+
+#endif // STRATEGYTABLEFILE_H
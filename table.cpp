@@ -0,0 +1,394 @@
+#include "table.h"
+#include "session.h"
+#include "shuffleworker.h"
+#include <algorithm>
+#include <random>
+
+// ---------------- RoundStats ----------------
+
+void RoundStats::add(const RoundResult& r)
+{
+    const int n = r.net();
+    rounds++;
+    wagered += r.wager;
+    net += n;
+    netSquared += static_cast<double>(n) * n;
+    if (n > 0) wins++;
+    else if (n < 0) losses++;
+    else pushes++;
+}
+
+void RoundStats::merge(const RoundStats& other)
+{
+    rounds += other.rounds;
+    wagered += other.wagered;
+    net += other.net;
+    netSquared += other.netSquared;
+    wins += other.wins;
+    losses += other.losses;
+    pushes += other.pushes;
+}
+
+double RoundStats::houseEdge() const
+{
+    return wagered ? -static_cast<double>(net) / wagered : 0.0;
+}
+
+double RoundStats::netPerRound() const
+{
+    return rounds ? static_cast<double>(net) / rounds : 0.0;
+}
+
+double RoundStats::variancePerRound() const
+{
+    if (rounds < 2) return 0.0;
+    const double mean = netPerRound();
+    return (netSquared - rounds * mean * mean) / (rounds - 1);
+}
+
+// ---------------- Table ----------------
+
+Table::Table(const Rules& rules)
+    : currentRules(rules)
+    , cards(rules.numDecks, rules.penetration)
+    , rng((static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}())
+    , drawRng((static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}())
+{
+    cards.shuffle(rng);
+}
+
+Table::~Table() = default;
+
+void Table::setRules(const Rules& rules)
+{
+    const bool decksChanged = rules.numDecks != currentRules.numDecks;
+    // cards dealt before a shuffling machine came in would never come back
+    const bool csmChanged = rules.continuousShuffle != currentRules.continuousShuffle;
+    currentRules = rules;
+    if (recorder) recorder->setRules(rules);
+    cards.setPenetration(rules.penetration);
+    if (decksChanged) {
+        cards.setNumDecks(rules.numDecks);
+    }
+    if (decksChanged || csmChanged) {
+        reshuffle();
+    }
+}
+
+void Table::seed(std::uint64_t seed, std::uint64_t stream)
+{
+    if (recorder) recorder->seed(seed, stream);
+    rng.seed(seed, stream);
+    drawRng.seed(seed, ~stream); // its own sequence, so shuffles don't depend on how many cards were drawn
+    cards.shuffle(rng);
+    // anything the worker had was shuffled off the old seed
+    if (shuffler) shuffler->prepare(cards.numDecks(), rng);
+}
+
+void Table::setRecorder(SessionRecorder* r)
+{
+    recorder = r;
+    if (recorder) {
+        recorder->setRules(currentRules);
+        recorder->setBalance(bank);
+    }
+}
+
+void Table::setBalance(long long amount)
+{
+    if (recorder) recorder->setBalance(amount);
+    bank = amount;
+}
+
+void Table::shuffle()
+{
+    if (recorder) recorder->shuffle();
+    reshuffle();
+}
+
+void Table::setBackgroundShuffle(bool enabled)
+{
+    if (enabled == static_cast<bool>(shuffler)) return;
+    if (enabled) {
+        shuffler = std::make_unique<ShuffleWorker>();
+        shuffler->prepare(cards.numDecks(), rng);
+    } else {
+        shuffler.reset();
+    }
+}
+
+void Table::reshuffle()
+{
+    // The worker shuffled with a copy of rng, so its shoe is the one
+    // shuffling here would make; take() fails over to that if the worker
+    // isn't finished or had a different deck count
+    if (shuffler && shuffler->take(cards.numDecks(), incoming, rng)) {
+        cards.swapIn(incoming);
+    } else {
+        cards.shuffle(rng);
+    }
+    if (shuffler) shuffler->prepare(cards.numDecks(), rng);
+}
+
+Card Table::drawCard()
+{
+    if (cards.empty()) {
+        reshuffle(); // only with penetration 1.0 - normally the cut card comes first
+    }
+    return currentRules.continuousShuffle ? cards.drawRandom(drawRng) : cards.draw();
+}
+
+void Table::returnCardsToShoe()
+{
+    // the hands keep their copies for display until the next deal
+    for (int i = 0; i < handsInPlay; ++i) {
+        for (Card c : hands[i]) cards.putBack(c);
+    }
+    for (Card c : dealer) cards.putBack(c);
+}
+
+bool Table::holeCardHidden() const
+{
+    return roundActive && !holeRevealed && dealer.size() > 1;
+}
+
+int Table::runningCount() const
+{
+    const int count = cards.runningCount();
+    return holeCardHidden() ? count - cards.countSystem().tag[dealer[1].rank()] : count;
+}
+
+double Table::trueCount() const
+{
+    const int unseen = cards.remaining() + (holeCardHidden() ? 1 : 0);
+    return unseen > 0 ? runningCount() * 52.0 / unseen : 0.0;
+}
+
+bool Table::placeBet(int amount)
+{
+    if (roundActive || amount <= 0 || amount > bank) return false;
+    beginRound(amount);
+    return true;
+}
+
+void Table::beginRound(int amount)
+{
+    if (recorder) recorder->bet(amount);
+
+    // Reshuffle between rounds once the cut card is out (a shuffling
+    // machine gets its cards back every round and has no cut card)
+    if (!currentRules.continuousShuffle && cards.pastCutCard()) {
+        reshuffle();
+    }
+
+    bet = amount;
+    bank -= amount; // Deduct bet immediately
+}
+
+void Table::dealInitialCards()
+{
+    if (recorder) recorder->deal();
+    Hand& player = hands[0];
+    player.clear();
+    dealer.clear();
+    handsInPlay = 1;
+    active = 0;
+    handBets[0] = bet;
+
+    player.push_back(drawCard());
+    dealer.push_back(drawCard());
+    player.push_back(drawCard());
+    dealer.push_back(drawCard());
+
+    holeRevealed = false;
+    surrenderOpen = true;
+    roundActive = true;
+}
+
+bool Table::splitAcesLocked() const
+{
+    // every hand of a split started with the same rank, so hand 0 tells
+    return handsInPlay > 1 && hands[0][0].isAce() && !currentRules.hitSplitAces;
+}
+
+void Table::finishHand()
+{
+    ++active;
+    // split aces that can't be split again are done with their one card
+    while (!playerTurnOver() && splitAcesLocked() && !canSplit()) {
+        ++active;
+    }
+}
+
+bool Table::canHit() const
+{
+    return roundActive && !playerTurnOver() && !splitAcesLocked();
+}
+
+Card Table::hit()
+{
+    if (!canHit()) return Card();
+    if (recorder) recorder->hit();
+    Card c = drawCard();
+    Hand& hand = hands[active];
+    hand.push_back(c);
+    surrenderOpen = false;
+    if (hand.value() > 21) finishHand();
+    return c;
+}
+
+bool Table::canSplit() const
+{
+    if (!roundActive || playerTurnOver() || !currentRules.allowSplit) return false;
+    if (handsInPlay >= std::min(currentRules.maxHands, MAX_HANDS)) return false;
+
+    const Hand& hand = hands[active];
+    if (hand.size() != 2 || hand[0].rank() != hand[1].rank() || bank < handBets[active]) return false;
+    // aces from a split only split again if the rules say so
+    return !(hand[0].isAce() && handsInPlay > 1 && !currentRules.resplitAces);
+}
+
+void Table::applyDouble()
+{
+    if (recorder) recorder->doubleDown();
+
+    bank -= handBets[active];
+    bet += handBets[active];
+    handBets[active] *= 2;
+    surrenderOpen = false;
+    hands[active].push_back(drawCard());
+    finishHand(); // one card and done
+}
+
+bool Table::split()
+{
+    if (!canSplit()) return false;
+    if (recorder) recorder->split();
+
+    // the new hand goes right after the one being split
+    for (int i = handsInPlay; i > active + 1; --i) {
+        hands[i] = hands[i - 1];
+        handBets[i] = handBets[i - 1];
+    }
+    Hand& first = hands[active];
+    Hand& second = hands[active + 1];
+    second.clear();
+    second.push_back(first.pop_back());
+    handBets[active + 1] = handBets[active];
+    bank -= handBets[active];
+    bet += handBets[active];
+    ++handsInPlay;
+    surrenderOpen = false;
+
+    first.push_back(drawCard());
+    second.push_back(drawCard());
+
+    // split aces without hitting: skip straight past the finished ones
+    if (splitAcesLocked() && !canSplit()) finishHand();
+    return true;
+}
+
+void Table::standHand()
+{
+    if (!roundActive || playerTurnOver()) return;
+    if (recorder) recorder->standHand();
+    finishHand();
+}
+
+bool Table::allHandsBust() const
+{
+    for (int i = 0; i < handsInPlay; ++i) {
+        if (hands[i].value() <= 21) return false;
+    }
+    return true;
+}
+
+void Table::revealHoleCard()
+{
+    if (recorder) recorder->revealHole();
+    holeRevealed = true;
+    surrenderOpen = false;
+    active = handsInPlay;
+}
+
+Card Table::dealerDraw()
+{
+    if (recorder) recorder->dealerDraw();
+    Card c = drawCard();
+    dealer.push_back(c);
+    return c;
+}
+
+RoundResult Table::finishSettlement(const RoundResult& r, bool allBust, bool dealerBust)
+{
+    bank += r.returned;
+    bet = 0;
+    if (currentRules.continuousShuffle) returnCardsToShoe();
+    if (recorder) recorder->endRound(allBust, dealerBust, r, bank);
+    return r;
+}
+
+RoundResult Table::surrender()
+{
+    RoundResult r;
+    r.outcome = Outcome::Surrendered;
+    r.handOutcome[0] = Outcome::Surrendered;
+    r.wager = bet;
+    // Player loses half the bet, rounded down
+    r.returned = bet - bet / 2;
+
+    bank += r.returned;
+    bet = 0;
+    roundActive = false;
+    surrenderOpen = false;
+    holeRevealed = true; // Reveal for completeness
+    active = handsInPlay;
+    if (currentRules.continuousShuffle) returnCardsToShoe();
+    if (recorder) recorder->surrender(bank);
+    return r;
+}
+
+TableSnapshot Table::snapshot() const
+{
+    TableSnapshot s;
+    s.balance = bank;
+    s.currentBet = bet;
+    s.inProgress = roundActive;
+    s.holeCardRevealed = holeRevealed;
+    s.canSurrender = surrenderOpen;
+    s.numDecks = currentRules.numDecks;
+    s.shoe = cards.contents();
+    s.player = hands[0];
+    s.dealer = dealer;
+    if (handsInPlay > 1) {
+        s.splitHands.assign(hands + 1, hands + handsInPlay);
+        s.handBets.assign(handBets, handBets + handsInPlay);
+    }
+    s.activeHand = active;
+    return s;
+}
+
+void Table::restore(const TableSnapshot& s)
+{
+    if (recorder) recorder->restore(s);
+    bank = s.balance;
+    bet = s.currentBet;
+    roundActive = s.inProgress;
+    holeRevealed = s.holeCardRevealed;
+    surrenderOpen = s.canSurrender;
+    currentRules.numDecks = s.numDecks;
+    cards.setNumDecks(s.numDecks);
+    cards.setContents(s.shoe);
+    hands[0] = s.player;
+    dealer = s.dealer;
+
+    handsInPlay = 1;
+    handBets[0] = bet;
+    if (!s.splitHands.empty() && s.splitHands.size() + 1 == s.handBets.size() && s.handBets.size() <= MAX_HANDS) {
+        handsInPlay = static_cast<int>(s.handBets.size());
+        for (int i = 1; i < handsInPlay; ++i) hands[i] = s.splitHands[i - 1];
+        for (int i = 0; i < handsInPlay; ++i) handBets[i] = s.handBets[i];
+    }
+    // finished rounds and the dealer's turn have no hand left to play
+    active = (!roundActive || holeRevealed) ? handsInPlay : std::clamp(s.activeHand, 0, handsInPlay);
+}
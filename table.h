@@ -0,0 +1,409 @@
+#ifndef TABLE_H
+#define TABLE_H
+
+#include "card.h"
+#include "hand.h"
+#include "rng.h"
+#include "shoe.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Headless blackjack rules engine. Holds everything about one table
+// (shoe, hands, bet, balance) and knows how to settle a round, but
+// nothing about widgets. MainWindow drives one of these, the simulator
+// drives millions of rounds through playRounds().
+
+class SessionRecorder;
+class ShuffleWorker;
+
+constexpr int MAX_HANDS = 4; // player hands after splitting and re-splitting
+
+inline int handValue(const Hand& hand) { return hand.value(); }
+inline bool isSoftHand(const Hand& hand) { return hand.isSoft(); } // an ace is still counting 11
+
+struct Rules {
+    int numDecks = 1;
+    double penetration = 0.75; // share of the shoe dealt before the cut card
+    int dealerTarget = 17;   // dealer draws while below this (18 in hard mode)
+    int blackjackPayNum = 3; // natural pays blackjackPayNum:blackjackPayDen
+    int blackjackPayDen = 2;
+    bool allowDouble = true;
+    bool allowSurrender = true;
+    bool allowSplit = true;
+    int maxHands = MAX_HANDS;      // split and re-split up to this many hands
+    bool doubleAfterSplit = true;
+    bool resplitAces = false;
+    bool hitSplitAces = false;     // split aces get one card each and stand
+    bool continuousShuffle = false; // CSM: every round's cards go back into the shoe at random
+
+    bool operator==(const Rules& o) const
+    {
+        return numDecks == o.numDecks && penetration == o.penetration && dealerTarget == o.dealerTarget
+            && blackjackPayNum == o.blackjackPayNum && blackjackPayDen == o.blackjackPayDen
+            && allowDouble == o.allowDouble && allowSurrender == o.allowSurrender
+            && allowSplit == o.allowSplit && maxHands == o.maxHands && doubleAfterSplit == o.doubleAfterSplit
+            && resplitAces == o.resplitAces && hitSplitAces == o.hitSplitAces
+            && continuousShuffle == o.continuousShuffle;
+    }
+    bool operator!=(const Rules& o) const { return !(*this == o); }
+};
+
+// How a round reads the rules that matter on every hand. This one reads
+// them from the table's Rules; a RuleSet (ruleset.h) pins them at
+// compile time so the simulator's round loop doesn't branch on them.
+struct DynamicRuleSet {
+    static int dealerTarget(const Rules& r) { return r.dealerTarget; }
+    static int blackjackPayNum(const Rules& r) { return r.blackjackPayNum; }
+    static int blackjackPayDen(const Rules& r) { return r.blackjackPayDen; }
+    static bool doubleAfterSplit(const Rules& r) { return r.doubleAfterSplit; }
+    static bool allowSurrender(const Rules& r) { return r.allowSurrender; }
+};
+
+enum class Action { Hit, Stand, Double, Split, Surrender };
+
+enum class Outcome {
+    BothBust,        // not settled any more, a busted hand loses; kept so session files keep their numbers
+    PlayerBust,
+    DealerBust,
+    BothBlackjack,
+    PlayerBlackjack,
+    DealerBlackjack,
+    PlayerWins,
+    DealerWins,
+    Push,
+    Surrendered
+};
+
+struct RoundResult {
+    Outcome outcome = Outcome::Push; // of the first hand, the only one unless split
+    int wager = 0;    // total staked this round (after doubling and splitting)
+    int returned = 0; // paid back to the balance, stake included
+    int hands = 1;
+    Outcome handOutcome[MAX_HANDS] = {};
+
+    int net() const { return returned - wager; }
+    bool playerWon() const { return returned > wager; }
+    bool playerLost() const { return returned < wager && outcome != Outcome::Surrendered; }
+};
+
+// Running totals for batch play
+struct RoundStats {
+    long long rounds = 0;
+    long long wagered = 0;
+    long long net = 0;
+    double netSquared = 0.0;
+    long long wins = 0;
+    long long losses = 0;
+    long long pushes = 0;
+
+    void add(const RoundResult& r);
+    void merge(const RoundStats& other);
+    double houseEdge() const;      // -net / wagered
+    double netPerRound() const;
+    double variancePerRound() const;
+};
+
+// Everything needed to put a table back exactly as it was (save/load)
+struct TableSnapshot {
+    long long balance = 0;
+    int currentBet = 0;
+    bool inProgress = false;
+    bool holeCardRevealed = false;
+    bool canSurrender = false;
+    int numDecks = 1;
+    std::vector<Card> shoe;
+    Hand player;    // first hand, the only one unless split
+    Hand dealer;
+
+    // after a split: the other hands, every hand's stake (currentBet is
+    // the sum) and the hand being played (handBets.size() once all are done)
+    std::vector<Hand> splitHands;
+    std::vector<int> handBets;
+    int activeHand = 0;
+};
+
+class Table
+{
+public:
+    explicit Table(const Rules& rules = Rules());
+    ~Table();
+
+    const Rules& rules() const { return currentRules; }
+    void setRules(const Rules& rules);
+    // pick the random sequence; the same (seed, stream) deals the same cards
+    void seed(std::uint64_t seed, std::uint64_t stream = 0);
+
+    long long balance() const { return bank; }
+    void setBalance(long long amount);
+    int currentBet() const { return bet; }
+    bool inProgress() const { return roundActive; }
+    bool canSurrender() const { return surrenderAllowed<DynamicRuleSet>(); }
+    bool holeCardRevealed() const { return holeRevealed; }
+
+    // the hand being played (the last one once the player is done)
+    const Hand& playerHand() const { return hands[active < handsInPlay ? active : handsInPlay - 1]; }
+    const Hand& playerHand(int index) const { return hands[index]; }
+    int handCount() const { return handsInPlay; }
+    int activeHand() const { return active; }  // handCount() once every hand is finished
+    int handBet(int index) const { return handBets[index]; }
+    const Hand& dealerHand() const { return dealer; }
+    int playerValue() const { return playerHand().value(); }
+    int dealerValue() const { return dealer.value(); }
+    const Shoe& shoe() const { return cards; }
+
+    // count of the cards the player has seen: the shoe's, less the
+    // dealer's hole card while it's face down. True count is per deck
+    // of unseen cards.
+    void setCountSystem(CountSystemId id) { cards.setCountSystem(id); }
+    int runningCount() const;
+    double trueCount() const;
+
+    void shuffle();
+    Card drawCard();
+
+    // shuffle the next shoe on a worker thread while this one is dealt,
+    // so the reshuffle at the cut card costs nothing (see ShuffleWorker).
+    // For the window's table; simulations keep their threads busy already.
+    void setBackgroundShuffle(bool enabled);
+
+    // --- step by step play (what the buttons do) ---
+    // Hands are played in order. A hand is finished by standHand(), by
+    // busting, or by doubling; once the last one is, playerTurnOver() is
+    // true and the dealer plays (unless every hand bust) before endRound().
+    bool placeBet(int amount);  // false if a round is running or amount is not affordable
+    void dealInitialCards();
+    bool canHit() const;
+    Card hit();
+    bool canDouble() const { return doubleAllowed<DynamicRuleSet>(); }
+    bool canSplit() const;
+    bool doubleDown() { return doubleDownAs<DynamicRuleSet>(); } // false if the balance can't cover it
+    bool split();               // false if the hand isn't a pair or the balance can't cover it
+    void standHand();
+    bool playerTurnOver() const { return active >= handsInPlay; }
+    bool allHandsBust() const;
+    void revealHoleCard();      // also ends the player's turn
+    bool dealerShouldDraw() const { return dealer.value() < DynamicRuleSet::dealerTarget(currentRules); }
+    Card dealerDraw();
+    void playDealer() { playDealerAs<DynamicRuleSet>(); }
+    RoundResult endRound() { return settle<DynamicRuleSet>(); } // every hand in one pass
+    RoundResult surrender();
+
+    TableSnapshot snapshot() const;
+    void restore(const TableSnapshot& s);
+
+    // every change to the table from here on is also written to recorder
+    // (null to stop), starting with the current rules and balance. Seed
+    // the table after attaching so the shoe can be dealt again. See session.h.
+    void setRecorder(SessionRecorder* r);
+
+    // --- batch play ---
+    // policy is anything callable as Action(const Table&), asked once
+    // per decision on the hand being played. Doubles and splits that
+    // aren't available are played as a hit.
+    // RuleSet is DynamicRuleSet, or a RuleSet matching rules() exactly
+    // (see withRuleSet) for a round loop specialized on it.
+    template <typename RuleSet = DynamicRuleSet, typename Policy>
+    RoundResult playRound(int amount, Policy&& policy);
+
+    // Plays n rounds and returns the totals. Bankroll is not a limit here,
+    // balance() afterwards is the old balance plus the net result.
+    // amount is a flat bet, or callable as int(const Table&) to pick each
+    // round's bet from the table as it stands (say, off the true count).
+    // Payouts are whole chips, so bet a multiple of 10: at 1 a natural
+    // pays 1:1 and surrender gives the whole bet back.
+    template <typename RuleSet = DynamicRuleSet, typename Policy, typename Bet>
+    RoundStats playRounds(long long n, Policy&& policy, Bet amount);
+
+private:
+    void beginRound(int amount);
+    void reshuffle();
+    void returnCardsToShoe();
+
+    // the rule dependent steps, for any RuleSet
+    template <typename RuleSet> bool surrenderAllowed() const;
+    template <typename RuleSet> bool doubleAllowed() const;
+    template <typename RuleSet> bool doubleDownAs();
+    template <typename RuleSet> void playDealerAs();
+    template <typename RuleSet> RoundResult settle();
+    // and the rule independent ends of them
+    void applyDouble();
+    RoundResult finishSettlement(const RoundResult& r, bool allBust, bool dealerBust);
+    void finishHand();
+    bool splitAcesLocked() const;
+    bool holeCardHidden() const;
+
+    Rules currentRules;
+    Shoe cards;
+    Rng rng;        // shuffles only, so ShuffleWorker can run ahead of it
+    Rng drawRng;    // picks the card in continuous shuffle mode
+    std::unique_ptr<ShuffleWorker> shuffler;
+    std::vector<Card> incoming; // rotates with the worker's buffer
+
+    Hand hands[MAX_HANDS];
+    int handBets[MAX_HANDS] = {};
+    int handsInPlay = 1;
+    int active = 0;
+    Hand dealer;
+    long long bank = 0;
+    int bet = 0;
+    bool roundActive = false;
+    bool holeRevealed = false;
+    bool surrenderOpen = false;
+
+    SessionRecorder* recorder = nullptr;
+};
+
+// Simple reference policy: hit until the hand reaches a target, never
+// double or surrender.
+struct HitUntilPolicy {
+    int target = 17;
+    Action operator()(const Table& t) const
+    {
+        return t.playerValue() < target ? Action::Hit : Action::Stand;
+    }
+};
+
+template <typename RuleSet>
+bool Table::surrenderAllowed() const
+{
+    return surrenderOpen && RuleSet::allowSurrender(currentRules);
+}
+
+template <typename RuleSet>
+bool Table::doubleAllowed() const
+{
+    if (!roundActive || playerTurnOver() || !currentRules.allowDouble || splitAcesLocked()) return false;
+    if (handsInPlay > 1 && !RuleSet::doubleAfterSplit(currentRules)) return false;
+    return bank >= handBets[active];
+}
+
+template <typename RuleSet>
+bool Table::doubleDownAs()
+{
+    if (!doubleAllowed<RuleSet>()) return false;
+    applyDouble();
+    return true;
+}
+
+template <typename RuleSet>
+void Table::playDealerAs()
+{
+    while (dealer.value() < RuleSet::dealerTarget(currentRules)) {
+        dealerDraw();
+    }
+}
+
+template <typename RuleSet>
+RoundResult Table::settle()
+{
+    holeRevealed = true;
+    surrenderOpen = false;
+    roundActive = false;
+    active = handsInPlay;
+
+    RoundResult r;
+    r.wager = bet;
+    r.hands = handsInPlay;
+
+    const int dealerTotal = dealer.value();
+    const bool dealerBust = dealerTotal > 21;
+    const bool dealerNatural = (dealerTotal == 21 && dealer.size() == 2);
+    bool allBust = true;
+
+    for (int i = 0; i < handsInPlay; ++i) {
+        const Hand& hand = hands[i];
+        const int stake = handBets[i];
+        const int playerTotal = hand.value();
+        const bool playerBust = playerTotal > 21;
+        // 21 on two cards after a split is just 21
+        const bool playerNatural = (playerTotal == 21 && hand.size() == 2 && handsInPlay == 1);
+
+        Outcome outcome;
+        int returned = 0;
+        // a busted hand loses even if the dealer busts too (the dealer
+        // plays while any split hand is still live)
+        // a natural is paid as one whatever the dealer draws to after it
+        if (playerBust) {
+            outcome = Outcome::PlayerBust;
+        } else if (playerNatural && dealerNatural) {
+            outcome = Outcome::BothBlackjack;
+            returned = stake;
+        } else if (playerNatural) {
+            outcome = Outcome::PlayerBlackjack;
+            returned = stake + stake * RuleSet::blackjackPayNum(currentRules) / RuleSet::blackjackPayDen(currentRules);
+        } else if (dealerBust) {
+            outcome = Outcome::DealerBust;
+            returned = stake * 2;
+        } else if (dealerNatural) {
+            outcome = Outcome::DealerBlackjack;
+        } else if (playerTotal > dealerTotal) {
+            outcome = Outcome::PlayerWins;
+            returned = stake * 2;
+        } else if (playerTotal < dealerTotal) {
+            outcome = Outcome::DealerWins;
+        } else {
+            outcome = Outcome::Push;
+            returned = stake;
+        }
+
+        r.handOutcome[i] = outcome;
+        r.returned += returned;
+        allBust = allBust && playerBust;
+    }
+    r.outcome = r.handOutcome[0];
+    return finishSettlement(r, allBust, dealerBust);
+}
+
+template <typename RuleSet, typename Policy>
+RoundResult Table::playRound(int amount, Policy&& policy)
+{
+    beginRound(amount);
+    dealInitialCards();
+
+    while (!playerTurnOver()) {
+        const Action a = policy(static_cast<const Table&>(*this));
+
+        if (a == Action::Surrender && surrenderAllowed<RuleSet>()) {
+            return surrender();
+        }
+        if (a == Action::Split && canSplit()) {
+            split();
+        } else if (a == Action::Double && doubleDownAs<RuleSet>()) {
+            // doubled, and that hand is done
+        } else if (a == Action::Stand || !canHit()) {
+            standHand();
+        } else {
+            hit();
+        }
+    }
+
+    if (!allHandsBust()) {
+        revealHoleCard();
+        playDealerAs<RuleSet>();
+    }
+    return settle<RuleSet>();
+}
+
+template <typename RuleSet, typename Policy, typename Bet>
+RoundStats Table::playRounds(long long n, Policy&& policy, Bet amount)
+{
+    const long long startBalance = bank;
+    bank = std::numeric_limits<long long>::max() / 2;
+
+    RoundStats stats;
+    for (long long i = 0; i < n; ++i) {
+        if constexpr (std::is_invocable_v<Bet&, const Table&>) {
+            stats.add(playRound<RuleSet>(amount(static_cast<const Table&>(*this)), policy));
+        } else {
+            stats.add(playRound<RuleSet>(amount, policy));
+        }
+    }
+
+    bank = startBalance + stats.net;
+    return stats;
+}
+
+#endif // TABLE_H
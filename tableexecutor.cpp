@@ -0,0 +1,80 @@
+#include "tableexecutor.h"
+#include "trace.h"
+#include <algorithm>
+
+TableExecutor::TableExecutor(int strandCount, int threadCount)
+    : strands(static_cast<std::size_t>(std::max(strandCount, 1)))
+{
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (threadCount <= 0) threadCount = 1;
+    }
+    threadCount = std::min(threadCount, static_cast<int>(strands.size()));
+
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&TableExecutor::workerLoop, this);
+    }
+}
+
+TableExecutor::~TableExecutor()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) {
+        t.join(); // workers only leave once the ready list is empty
+    }
+}
+
+void TableExecutor::post(int strand, std::function<void()> task)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    Strand& s = strands[strand];
+    s.tasks.push_back(std::move(task));
+    ++pending;
+    if (!s.scheduled) {
+        s.scheduled = true;
+        ready.push_back(strand);
+        wake.notify_one();
+    }
+}
+
+void TableExecutor::wait()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    idle.wait(guard, [&] { return pending == 0; });
+}
+
+void TableExecutor::workerLoop()
+{
+    Trace::nameThread("Table worker");
+
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;) {
+        wake.wait(guard, [&] { return stopping || !ready.empty(); });
+        if (ready.empty()) return; // stopping and nothing left to run
+
+        const int index = ready.front();
+        ready.pop_front();
+        std::function<void()> task = std::move(strands[index].tasks.front());
+        strands[index].tasks.pop_front();
+
+        // the strand stays scheduled while its task runs, so nobody else
+        // picks it up in the meantime
+        guard.unlock();
+        task();
+        task = nullptr; // drop captures before taking the lock again
+        guard.lock();
+
+        Strand& s = strands[index];
+        if (s.tasks.empty()) {
+            s.scheduled = false;
+        } else {
+            ready.push_back(index);
+            wake.notify_one();
+        }
+        if (--pending == 0) idle.notify_all();
+    }
+}
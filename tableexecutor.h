@@ -0,0 +1,57 @@
+#ifndef TABLEEXECUTOR_H
+#define TABLEEXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs the engines of many tables on a few threads. Every table gets a
+// strand: tasks posted to one strand run one at a time and in the order
+// they were posted, so a Table is only ever touched by one thread at a
+// time, while different tables run in parallel. A strand runs one task
+// per turn and then goes to the back of the line, so a busy table can't
+// starve the others.
+//
+// Threads sleep until something is posted; tables nobody is playing at
+// cost nothing.
+class TableExecutor
+{
+public:
+    // threads <= 0 means one per hardware thread, but never more than strands
+    explicit TableExecutor(int strands, int threads = 0);
+    ~TableExecutor(); // runs everything already posted first
+
+    TableExecutor(const TableExecutor&) = delete;
+    TableExecutor& operator=(const TableExecutor&) = delete;
+
+    int strandCount() const { return static_cast<int>(strands.size()); }
+    int threadCount() const { return static_cast<int>(threads.size()); }
+
+    void post(int strand, std::function<void()> task);
+
+    // wait until every task posted so far has run
+    void wait();
+
+private:
+    struct Strand {
+        std::deque<std::function<void()>> tasks;
+        bool scheduled = false; // in the ready list or running right now
+    };
+
+    void workerLoop();
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::vector<Strand> strands;
+    std::deque<int> ready;
+    long long pending = 0;
+    bool stopping = false;
+
+    std::vector<std::thread> threads;
+};
+
+#endif // TABLEEXECUTOR_H
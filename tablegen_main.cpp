@@ -0,0 +1,59 @@
+// blackjack_tablegen - builds the strategy tables the game and the
+// simulator map at startup (see strategytablefile.h).
+//
+//   blackjack_tablegen [--out FILE] [--threads T]
+//
+// One table per rule set in StrategyTableFile::standardRules(), each
+// worked out exactly with EvSolver. Takes a while; it runs once per build.
+
+#include "strategytablefile.h"
+#include "workstealingpool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+    std::string path = StrategyTableFile::DEFAULT_NAME;
+    int threads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (!std::strcmp(arg, "--out") && hasValue) path = argv[++i];
+        else if (!std::strcmp(arg, "--threads") && hasValue) threads = std::atoi(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: blackjack_tablegen [--out FILE] [--threads T]\n");
+            return 1;
+        }
+    }
+
+    const std::vector<Rules> rules = StrategyTableFile::standardRules();
+    std::vector<StrategyTable> tables(rules.size());
+
+    WorkStealingPool pool(threads);
+    const auto start = std::chrono::steady_clock::now();
+    pool.run(static_cast<std::int64_t>(rules.size()), [&](std::int64_t task, int) {
+        tables[task] = StrategyTable::build(rules[task]);
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!StrategyTableFile::write(path, tables)) {
+        std::fprintf(stderr, "could not write %s\n", path.c_str());
+        return 1;
+    }
+
+    // read it back the way the game will
+    StrategyTableFile check;
+    if (!check.open(path) || check.size() != tables.size()) {
+        std::fprintf(stderr, "%s doesn't read back\n", path.c_str());
+        return 1;
+    }
+
+    std::printf("%d tables in %.2f s on %d threads -> %s\n", static_cast<int>(tables.size()), seconds,
+                pool.threadCount(), path.c_str());
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+std::atomic<bool> Trace::on{false};
+
+namespace {
+
+struct Event {
+    const char* name;
+    const char* category;
+    char phase;            // 'X' complete, 'i' instant
+    int tid;
+    std::int64_t ts;
+    std::int64_t dur;
+};
+
+// spans come from user actions and background jobs, a few thousand per
+// minute at most, so one lock is plenty
+std::mutex lock;
+std::vector<Event> events;                        // guarded by lock
+std::vector<std::pair<int, std::string>> threads; // guarded by lock
+std::FILE* out = nullptr;                         // guarded by lock
+
+const auto epoch = std::chrono::steady_clock::now();
+std::atomic<int> nextTid{1};
+
+int threadId()
+{
+    thread_local const int tid = nextTid.fetch_add(1, std::memory_order_relaxed);
+    return tid;
+}
+
+void writeString(std::FILE* f, const char* s)
+{
+    std::fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        std::fputc(*s, f);
+    }
+    std::fputc('"', f);
+}
+
+} // namespace
+
+bool Trace::start(const std::string& path)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    if (out) return true;
+
+    out = std::fopen(path.c_str(), "w");
+    if (!out) return false;
+
+    events.reserve(1 << 16);
+    static bool registered = false;
+    if (!registered) {
+        std::atexit(&Trace::stop); // quit() paths still get a trace
+        registered = true;
+    }
+    on.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void Trace::stop()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    on.store(false, std::memory_order_relaxed);
+    if (!out) return;
+
+    std::fputs("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n", out);
+    bool first = true;
+    for (const auto& t : threads) {
+        std::fprintf(out, "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": ",
+                     first ? "" : ",\n", t.first);
+        writeString(out, t.second.c_str());
+        std::fputs("}}", out);
+        first = false;
+    }
+    for (const Event& e : events) {
+        std::fputs(first ? "{\"name\": " : ",\n{\"name\": ", out);
+        writeString(out, e.name);
+        std::fputs(", \"cat\": ", out);
+        writeString(out, e.category);
+        if (e.phase == 'X') {
+            std::fprintf(out, ", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %lld, \"dur\": %lld}",
+                         e.tid, static_cast<long long>(e.ts), static_cast<long long>(e.dur));
+        } else {
+            std::fprintf(out, ", \"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": %d, \"ts\": %lld}",
+                         e.tid, static_cast<long long>(e.ts));
+        }
+        first = false;
+    }
+    std::fputs("\n]}\n", out);
+    std::fclose(out);
+    out = nullptr;
+    events.clear();
+}
+
+std::int64_t Trace::nowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Trace::complete(const char* name, const char* category, std::int64_t startUs, std::int64_t durationUs)
+{
+    const int tid = threadId();
+    std::lock_guard<std::mutex> guard(lock);
+    if (out) events.push_back(Event{ name, category, 'X', tid, startUs, durationUs });
+}
+
+void Trace::instant(const char* name, const char* category)
+{
+    if (!enabled()) return;
+    const int tid = threadId();
+    const std::int64_t now = nowMicros();
+    std::lock_guard<std::mutex> guard(lock);
+    if (out) events.push_back(Event{ name, category, 'i', tid, now, 0 });
+}
+
+void Trace::nameThread(const char* name)
+{
+    // names are cheap to keep, so they're taken even before start()
+    const int tid = threadId();
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto& t : threads) {
+        if (t.first == tid) {
+            t.second = name;
+            return;
+        }
+    }
+    threads.emplace_back(tid, name);
+}
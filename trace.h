@@ -0,0 +1,64 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Opt-in timeline tracing, written as Chrome trace JSON (open it in
+// chrome://tracing or ui.perfetto.dev).
+//
+// Nothing is recorded until Trace::start(); a disabled span costs one
+// relaxed atomic load. Spans are kept in memory and written out by
+// Trace::stop() (also run at exit). Span names and categories must be
+// string literals or otherwise outlive the trace.
+//
+//   TRACE_SCOPE("MainWindow::hit", "slot");
+
+class Trace
+{
+public:
+    static bool enabled() { return on.load(std::memory_order_relaxed); }
+
+    // false if the file can't be created
+    static bool start(const std::string& path);
+    static void stop();
+
+    static std::int64_t nowMicros();
+
+    static void complete(const char* name, const char* category, std::int64_t startUs, std::int64_t durationUs);
+    static void instant(const char* name, const char* category);
+
+    // label for the calling thread on the timeline
+    static void nameThread(const char* name);
+
+private:
+    static std::atomic<bool> on;
+};
+
+class TraceSpan
+{
+public:
+    TraceSpan(const char* name, const char* category)
+        : name(name), category(category), startUs(Trace::enabled() ? Trace::nowMicros() : -1)
+    {
+    }
+    ~TraceSpan()
+    {
+        if (startUs >= 0) Trace::complete(name, category, startUs, Trace::nowMicros() - startUs);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    std::int64_t startUs;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name, category) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(name, category)
+
+#endif // TRACE_H
@@ -1,6 +1,7 @@
 // include header and ui header
 #include "welcome.h"
 #include "ui_welcome.h"
+#include "trace.h"
 #include <QDir>
 #include <QDebug>
 #include <QDesktopServices>
@@ -13,6 +14,7 @@ Welcome::Welcome(QWidget *parent)
     : QDialog(parent),
     ui(new Ui::Welcome)
 {
+    TRACE_SCOPE("Welcome::setupUi", "startup");
     ui->setupUi(this);
     ui->introText->setOpenExternalLinks(true);
     ui->textBrowser->setOpenExternalLinks(true);
@@ -105,6 +107,7 @@ void Welcome::on_finishButton_clicked() {
     if(difficulty == 2){selectedFolder = "C:/Windows/System32";}
 
     // Write settings to file
+    TRACE_SCOPE("write settings.txt", "startup");
     std::ofstream outFile("settings.txt");
     if (outFile.is_open()) {
         outFile << difficulty << "\n";                // line 1: difficulty
@@ -0,0 +1,107 @@
+#include "workstealingpool.h"
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+{
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (threadCount <= 0) threadCount = 1;
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(stateLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
+
+void WorkStealingPool::run(std::int64_t numTasks, const std::function<void(std::int64_t, int)>& job)
+{
+    if (numTasks <= 0) return;
+
+    const int n = threadCount();
+    for (std::int64_t task = 0; task < numTasks; ++task) {
+        Queue& q = *queues[task % n];
+        std::lock_guard<std::mutex> guard(q.lock);
+        q.tasks.push_back(task);
+    }
+
+    std::unique_lock<std::mutex> guard(stateLock);
+    currentJob = &job;
+    pending = numTasks;
+    idleWorkers = 0;
+    ++generation;
+    wake.notify_all();
+
+    // wait for every task to finish and every worker to park again, so
+    // job can safely go out of scope when we return
+    finished.wait(guard, [&] { return pending == 0 && idleWorkers == n; });
+    currentJob = nullptr;
+}
+
+bool WorkStealingPool::takeTask(int worker, std::int64_t& task)
+{
+    {
+        Queue& own = *queues[worker];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    const int n = threadCount();
+    for (int i = 1; i < n; ++i) {
+        Queue& victim = *queues[(worker + i) % n];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int index)
+{
+    std::uint64_t seenGeneration = 0;
+
+    for (;;) {
+        const std::function<void(std::int64_t, int)>* job;
+        {
+            std::unique_lock<std::mutex> guard(stateLock);
+            wake.wait(guard, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+            job = currentJob;
+        }
+
+        std::int64_t task;
+        std::int64_t done = 0;
+        while (takeTask(index, task)) {
+            (*job)(task, index);
+            ++done;
+        }
+
+        std::lock_guard<std::mutex> guard(stateLock);
+        pending -= done;
+        ++idleWorkers;
+        if (pending == 0 && idleWorkers == threadCount()) {
+            finished.notify_all();
+        }
+    }
+}
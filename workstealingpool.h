@@ -0,0 +1,56 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork/join pool for splitting a big job into numbered tasks.
+// Tasks are dealt round-robin onto per-worker queues; a worker takes from
+// the back of its own queue and, when that runs out, steals from the front
+// of someone else's. Chunks that happen to run slow (long shoes, a busy
+// core) don't leave the other threads idle at the end.
+class WorkStealingPool
+{
+public:
+    // threads <= 0 means one per hardware thread
+    explicit WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int threadCount() const { return static_cast<int>(queues.size()); }
+
+    // Runs job(task, worker) for every task in [0, numTasks) and returns
+    // when all of them are done. worker is in [0, threadCount()).
+    void run(std::int64_t numTasks, const std::function<void(std::int64_t task, int worker)>& job);
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<std::int64_t> tasks;
+    };
+
+    void workerLoop(int index);
+    bool takeTask(int worker, std::int64_t& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex stateLock;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(std::int64_t, int)>* currentJob = nullptr;
+    std::uint64_t generation = 0;
+    std::int64_t pending = 0;
+    int idleWorkers = 0;
+    bool stopping = false;
+};
+
+#endif // WORKSTEALINGPOOL_H